@@ -0,0 +1,314 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <disassembler.h>
+#include <emulator.h>
+#include <invaders.h>
+#include <metrics.h>
+#include <opcodes.h>
+#include <timeline.h>
+#include <workloads.h>
+
+namespace {
+
+constexpr uint16_t opcodeAddress = 0x1000;
+
+// Places op at opcodeAddress with operands that point back at it, so branches, calls and loads
+// stay inside a single page no matter how often the op repeats.
+void prepareOpcode(Emulator& emulator, Byte op) {
+    Status& status = emulator.status_;
+    status.memory[opcodeAddress] = op;
+    status.memory[opcodeAddress + 1] = opcodeAddress & 0xff;
+    status.memory[opcodeAddress + 2] = opcodeAddress >> 8;
+    status.h = 0x20;
+    status.l = 0x00;
+    status.sp = 0x3000;
+    status.pc = opcodeAddress;
+}
+
+bool isImplemented(Byte op) {
+    Emulator emulator;
+    prepareOpcode(emulator, op);
+    return emulator.emulateOp() != StopReason::UNIMPLEMENTED_OPCODE;
+}
+
+void BM_Opcode(benchmark::State& state, Byte op) {
+    Emulator emulator;
+    prepareOpcode(emulator, op);
+    Status& status = emulator.status_;
+    for (auto _: state) {
+        status.pc = opcodeAddress;
+        status.sp = 0x3000;
+        emulator.emulateOp();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_Workload(benchmark::State& state, Workload const* workload) {
+    Emulator emulator;
+    uint64_t ops = 0;
+    uint64_t cycles = 0;
+    for (auto _: state) {
+        ops += runWorkload(emulator, *workload);
+        cycles += emulator.status_.cycles;
+    }
+    state.SetItemsProcessed(ops);
+    state.counters["cycles"] = benchmark::Counter(cycles, benchmark::Counter::kIsRate);
+}
+
+// A workload through Emulator::run with and without superinstructions. dispatches/op is the number
+// of times the run loop dispatched per guest op; 1 without fusion.
+void BM_Fusion(benchmark::State& state, Workload const* workload, bool fusion) {
+    Emulator emulator;
+    uint64_t const ops = runWorkload(emulator, *workload) + 1;     // With the HLT.
+    emulator.setFusion(fusion);
+    uint64_t cycles = 0;
+    for (auto _: state) {
+        loadWorkload(emulator, *workload);  // The data too, or later passes take other paths.
+        emulator.run(UINT64_MAX);
+        cycles += emulator.status_.cycles;
+    }
+    state.SetItemsProcessed(ops * state.iterations());
+    state.counters["cycles"] = benchmark::Counter(cycles, benchmark::Counter::kIsRate);
+    state.counters["dispatches/op"] = 1 - double(emulator.fusedDispatches()) / (ops * state.iterations());
+}
+
+// Emulator::run over the memcpy loop with nothing set, with a breakpoint that never hits (the bit
+// test per op) and with a watchpoint on an untouched page (working out every op's memory access).
+void BM_Run(benchmark::State& state, int debug) {
+    Emulator emulator;
+    Workload const& workload = standardWorkloads()[0];
+    if (debug >= 1) { emulator.debugger_.addBreakpoint(0xe000); }
+    if (debug >= 2) { emulator.debugger_.addWatchpoint(0xe000, 0x100, WATCH_ACCESS); }
+    uint64_t cycles = 0;
+    for (auto _: state) {
+        loadWorkload(emulator, workload);
+        emulator.run(100000);
+        cycles += emulator.status_.cycles;
+    }
+    state.counters["cycles"] = benchmark::Counter(cycles, benchmark::Counter::kIsRate);
+}
+BENCHMARK_CAPTURE(BM_Run, no_debug, 0);
+BENCHMARK_CAPTURE(BM_Run, breakpoint, 1);
+BENCHMARK_CAPTURE(BM_Run, watchpoint, 2);
+
+// BM_Run/no_debug with the copy loop run natively by Idioms, against the interpreter.
+void BM_Idioms(benchmark::State& state, bool enabled) {
+    Emulator emulator;
+    Workload const& workload = standardWorkloads()[0];
+    emulator.idioms_.setEnabled(enabled);
+    uint64_t cycles = 0;
+    for (auto _: state) {
+        loadWorkload(emulator, workload);
+        emulator.run(100000);
+        cycles += emulator.status_.cycles;
+    }
+    state.counters["cycles"] = benchmark::Counter(cycles, benchmark::Counter::kIsRate);
+}
+BENCHMARK_CAPTURE(BM_Idioms, off, false);
+BENCHMARK_CAPTURE(BM_Idioms, on, true);
+
+// A loop of register pair ops: LDAX B, STAX D, INX B, INX D, DAD D, XCHG, XCHG, DCX H, XTHL, XTHL
+// and JMP back, from LXIs of all four pairs. The stores walk up from $2100 and stay clear of the code.
+void BM_PairOps(benchmark::State& state) {
+    Emulator emulator;
+    std::vector<Byte> const program {
+        0x31, 0x00, 0x30, 0x01, 0x00, 0x20, 0x11, 0x00, 0x21, 0x21, 0x00, 0x22,
+        0x0a, 0x12, 0x03, 0x13, 0x19, 0xeb, 0xeb, 0x2b, 0xe3, 0xe3, 0xc3, 0x0c, 0x00,
+    };
+    std::copy(program.begin(), program.end(), emulator.status_.memory.begin());
+    uint64_t cycles = 0;
+    for (auto _: state) {
+        emulator.status_.pc = 0;
+        uint64_t const start = emulator.status_.cycles;
+        emulator.run(100000);
+        cycles += emulator.status_.cycles - start;
+    }
+    state.counters["cycles"] = benchmark::Counter(cycles, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_PairOps);
+
+// Many machines on one core, each running the standard workloads in turn for slices of 500 states,
+// so every slice starts with its Status out of L1. Under perf stat, L1-dcache-load-misses per
+// cycle is the number the one-line Status keeps down.
+void BM_Instances(benchmark::State& state) {
+    std::vector<Emulator> emulators(state.range(0));
+    auto const& workloads = standardWorkloads();
+    for (size_t i = 0; i < emulators.size(); ++i) { loadWorkload(emulators[i], workloads[i % workloads.size()]); }
+    uint64_t cycles = 0;
+    for (auto _: state) {
+        for (size_t i = 0; i < emulators.size(); ++i) {
+            Emulator& emulator = emulators[i];
+            uint64_t const start = emulator.status_.cycles;
+            Stop const stop = emulator.run(500);
+            cycles += emulator.status_.cycles - start;
+            if (stop.reason == StopReason::HALTED) { loadWorkload(emulator, workloads[i % workloads.size()]); }
+        }
+    }
+    state.counters["cycles"] = benchmark::Counter(cycles, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Instances)->Arg(1)->Arg(16)->Arg(256)->Arg(1024);
+
+// BM_Run/no_debug with reverse execution on, snapshotting every interval states. Compare the cycle
+// rates: the default interval of 1M states should stay within a few percent.
+void BM_TimelineRun(benchmark::State& state) {
+    Emulator emulator;
+    Workload const& workload = standardWorkloads()[0];
+    Timeline timeline(state.range(0));
+    uint64_t cycles = 0;
+    for (auto _: state) {
+        // The cycle count carries on, or the timeline would start a new history every pass.
+        uint64_t const start = emulator.status_.cycles;
+        loadWorkload(emulator, workload);
+        emulator.status_.cycles = start;
+        timeline.run(emulator, 100000);
+        cycles += emulator.status_.cycles - start;
+    }
+    state.counters["cycles"] = benchmark::Counter(cycles, benchmark::Counter::kIsRate);
+    state.counters["snapshots"] = timeline.snapshots();
+}
+BENCHMARK(BM_TimelineRun)->Arg(10000)->Arg(100000)->Arg(1000000);
+
+// Draws a 16-row sprite at each of 256 columns the way Space Invaders does, with a routine at $1400
+// that shifts every byte through ports 4, 2 and 3. inline handles the ports in Emulator::emulateOp,
+// ports sends them through the machine's Ports::in and Ports::out.
+void BM_SpriteBlit(benchmark::State& state, bool inlined) {
+    std::vector<std::pair<uint16_t, std::vector<Byte>>> const program {
+        {0x0000, {
+            0x31, 0x00, 0x24,   // 0000 LXI SP,$2400
+            0x0e, 0x00,         // 0003 MVI C,0
+            0x11, 0x00, 0x1c,   // 0005 LXI D,$1c00
+            0x21, 0x00, 0x24,   // 0008 LXI H,$2400
+            0x69,               // 000b MOV L,C
+            0x79,               // 000c MOV A,C
+            0x06, 0x10,         // 000d MVI B,16
+            0xcd, 0x00, 0x14,   // 000f CALL $1400
+            0x0c,               // 0012 INR C
+            0xc2, 0x05, 0x00,   // 0013 JNZ $0005
+            0x76,               // 0016 HLT
+        }},
+        {0x1400, {
+            0xd3, 0x02,         // 1400 OUT 2
+            0xe5,               // 1402 PUSH H
+            0x1a,               // 1403 LDAX D
+            0xd3, 0x04,         // 1404 OUT 4
+            0xdb, 0x03,         // 1406 IN 3
+            0xb6,               // 1408 ORA M
+            0x77,               // 1409 MOV M,A
+            0x23,               // 140a INX H
+            0x13,               // 140b INX D
+            0xaf,               // 140c XRA A
+            0xd3, 0x04,         // 140d OUT 4
+            0xdb, 0x03,         // 140f IN 3
+            0xb6,               // 1411 ORA M
+            0x77,               // 1412 MOV M,A
+            0xe1,               // 1413 POP H
+            0xc5,               // 1414 PUSH B
+            0x01, 0x20, 0x00,   // 1415 LXI B,$0020
+            0x09,               // 1418 DAD B
+            0xc1,               // 1419 POP B
+            0x05,               // 141a DCR B
+            0xc2, 0x02, 0x14,   // 141b JNZ $1402
+            0xc9,               // 141e RET
+        }},
+        {0x1c00, {0x18, 0x3c, 0x7e, 0xdb, 0xff, 0x24, 0x5a, 0xa5, 0x18, 0x3c, 0x7e, 0xdb, 0xff, 0x24, 0x5a, 0xa5}},
+    };
+    Emulator emulator;
+    for (auto const& [address, bytes]: program) {
+        std::copy(bytes.begin(), bytes.end(), emulator.status_.memory.begin() + address);
+    }
+    Invaders machine;
+    if (inlined) {
+        machine.attach(emulator);
+    } else {
+        emulator.setPorts(&machine);
+    }
+    uint64_t cycles = 0;
+    for (auto _: state) {
+        emulator.status_.pc = 0;
+        emulator.status_.cycles = 0;
+        if (emulator.run(UINT64_MAX).reason != StopReason::HALTED) {
+            state.SkipWithError("the blit did not finish");
+            break;
+        }
+        cycles += emulator.status_.cycles;
+    }
+    state.counters["cycles"] = benchmark::Counter(cycles, benchmark::Counter::kIsRate);
+}
+BENCHMARK_CAPTURE(BM_SpriteBlit, ports, false);
+BENCHMARK_CAPTURE(BM_SpriteBlit, inline, true);
+
+// Unimplemented opcodes used to throw; this measures the status-code path under each policy.
+void BM_UnimplementedOpcode(benchmark::State& state, UnimplementedPolicy policy) {
+    Emulator emulator;
+    emulator.setUnimplementedPolicy(policy, [](Emulator&, Stop const&) { return true; });
+    prepareOpcode(emulator, 0xff);
+    Status& status = emulator.status_;
+    for (auto _: state) {
+        status.pc = opcodeAddress;
+        benchmark::DoNotOptimize(emulator.emulateOp());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_UnimplementedOpcode, halt, UnimplementedPolicy::HALT);
+BENCHMARK_CAPTURE(BM_UnimplementedOpcode, nop, UnimplementedPolicy::NOP);
+BENCHMARK_CAPTURE(BM_UnimplementedOpcode, callback, UnimplementedPolicy::CALLBACK);
+
+void BM_UpdateControls(benchmark::State& state) {
+    Emulator emulator;
+    uint16_t result = 0;
+    for (auto _: state) {
+        emulator.updateControls(result++, {CARRY, PARITY, SIGN, ZERO});
+        benchmark::DoNotOptimize(emulator.status_.controls);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UpdateControls);
+
+// Counter::add from several threads at once, each on its own slot's cache line.
+void BM_MetricsCounter(benchmark::State& state) {
+    static Counter counter;
+    for (auto _: state) { counter.add(); }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MetricsCounter)->Threads(1)->Threads(4);
+
+void BM_DisassembleOp(benchmark::State& state) {
+    std::vector<Byte> image(1 << 16);
+    for (size_t i = 0; i < image.size(); ++i) { image[i] = (i * 7919) >> 3; }
+    Disassembler const disassembler;
+    char line[Disassembler::maxLineLength];
+    uint16_t pc = 0;
+    for (auto _: state) {
+        char* out = line;
+        pc += disassembler.disassembleOp(pc, image, out);
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DisassembleOp);
+
+}
+
+int main(int argc, char** argv) {
+    for (int op = 0; op < 256; ++op) {
+        if (!isImplemented(op)) { continue; }
+        char name[32];
+        snprintf(name, sizeof name, "BM_Opcode/%02x", op);
+        benchmark::RegisterBenchmark(name, BM_Opcode, static_cast<Byte>(op));
+    }
+    for (auto const& workload: standardWorkloads()) {
+        benchmark::RegisterBenchmark(("BM_Workload/" + workload.name).c_str(), BM_Workload, &workload);
+        benchmark::RegisterBenchmark(("BM_Fusion/" + workload.name + "/off").c_str(), BM_Fusion, &workload, false);
+        benchmark::RegisterBenchmark(("BM_Fusion/" + workload.name + "/on").c_str(), BM_Fusion, &workload, true);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) { return 1; }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""Runs the workload benchmarks and fails when any of them regressed against bench/baseline.json.
+
+Noise control: the benchmark is pinned to one CPU with taskset when available, every workload is
+repeated and only the median of the repetitions is compared.
+
+    perf_gate.py --bench build/bench/bench                # compare against the baseline
+    perf_gate.py --bench build/bench/bench --update       # record a new baseline
+"""
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+
+def run_benchmarks(bench, pattern, repetitions, cpu, min_time):
+    command = [
+        bench,
+        "--benchmark_filter=" + pattern,
+        "--benchmark_repetitions=%d" % repetitions,
+        "--benchmark_report_aggregates_only=true",
+        "--benchmark_min_time=%g" % min_time,
+        "--benchmark_format=json",
+    ]
+    if cpu is not None and shutil.which("taskset"):
+        command = ["taskset", "-c", str(cpu)] + command
+    output = subprocess.run(command, check=True, stdout=subprocess.PIPE, text=True).stdout
+    return json.loads(output)
+
+
+def medians(results, metric):
+    found = {}
+    for entry in results["benchmarks"]:
+        if entry.get("aggregate_name") == "median" and metric in entry:
+            found[entry["run_name"]] = entry[metric]
+    return found
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--bench", required=True, help="path to the bench executable")
+    parser.add_argument("--baseline", default=os.path.join(HERE, "baseline.json"))
+    parser.add_argument("--threshold", type=float, help="allowed slowdown as a fraction, overrides the baseline's")
+    parser.add_argument("--repetitions", type=int, default=5)
+    parser.add_argument("--min-time", type=float, default=0.2, help="seconds per repetition")
+    parser.add_argument("--cpu", type=int, default=0, help="CPU to pin the benchmark to")
+    parser.add_argument("--update", action="store_true", help="write the measured medians as the new baseline")
+    args = parser.parse_args()
+
+    baseline = {"metric": "items_per_second", "filter": "BM_Workload", "threshold": 0.10, "benchmarks": {}}
+    if os.path.exists(args.baseline):
+        with open(args.baseline) as f:
+            baseline.update(json.load(f))
+    threshold = args.threshold if args.threshold is not None else baseline["threshold"]
+    metric = baseline["metric"]
+
+    results = run_benchmarks(args.bench, baseline["filter"], args.repetitions, args.cpu, args.min_time)
+    measured = medians(results, metric)
+    if not measured:
+        print("perf gate: no benchmark matched '%s'" % baseline["filter"], file=sys.stderr)
+        return 2
+
+    if args.update:
+        baseline["benchmarks"] = measured
+        with open(args.baseline, "w") as f:
+            json.dump(baseline, f, indent=2, sort_keys=True)
+            f.write("\n")
+        print("perf gate: recorded %d benchmarks in %s" % (len(measured), args.baseline))
+        return 0
+
+    failed = False
+    for name, expected in sorted(baseline["benchmarks"].items()):
+        actual = measured.get(name)
+        if actual is None:
+            print("%-28s missing from this run" % name)
+            failed = True
+            continue
+        change = actual / expected - 1.0
+        regressed = change < -threshold
+        failed |= regressed
+        print("%-28s %12.4g -> %12.4g %s/median  %+7.2f%%%s"
+              % (name, expected, actual, metric, 100 * change, "  REGRESSION" if regressed else ""))
+    for name in sorted(set(measured) - set(baseline["benchmarks"])):
+        print("%-28s %12s    %12.4g (not in baseline)" % (name, "", measured[name]))
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
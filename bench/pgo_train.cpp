@@ -0,0 +1,20 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include <iostream>
+#include <workloads.h>
+
+// Training run for the PGO build: exercises the interpreter on every standard workload.
+int main(int argc, char** argv) {
+    int const rounds = argc > 1 ? std::stoi(argv[1]) : 200;
+    Emulator emulator;
+    uint64_t ops = 0;
+    for (int round = 0; round < rounds; ++round) {
+        for (auto const& workload: standardWorkloads()) {
+            ops += runWorkload(emulator, workload);
+        }
+    }
+    std::cout << "trained on " << ops << " ops" << std::endl;
+    return 0;
+}
@@ -0,0 +1,55 @@
+# Applies CPU8080_LTO, CPU8080_PGO and CPU8080_ARCH to every target of the project.
+
+if (CPU8080_ARCH)
+    include(CheckCXXCompilerFlag)
+    check_cxx_compiler_flag("-march=${CPU8080_ARCH}" CPU8080_ARCH_SUPPORTED)
+    if (NOT CPU8080_ARCH_SUPPORTED)
+        message(FATAL_ERROR "The compiler does not accept -march=${CPU8080_ARCH}")
+    endif ()
+    add_compile_options(-march=${CPU8080_ARCH})
+endif ()
+
+if (CPU8080_LTO)
+    include(CheckIPOSupported)
+    check_ipo_supported(RESULT lto_supported OUTPUT lto_error)
+    if (NOT lto_supported)
+        message(FATAL_ERROR "LTO is not supported: ${lto_error}")
+    endif ()
+    set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)
+endif ()
+
+if (CPU8080_PGO STREQUAL "GENERATE")
+    file(MAKE_DIRECTORY ${CPU8080_PGO_DIR})
+    if (CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+        add_compile_options(-fprofile-generate=${CPU8080_PGO_DIR})
+        add_link_options(-fprofile-generate=${CPU8080_PGO_DIR})
+    elseif (CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+        add_compile_options(-fprofile-instr-generate=${CPU8080_PGO_DIR}/cpu8080-%p.profraw)
+        add_link_options(-fprofile-instr-generate=${CPU8080_PGO_DIR}/cpu8080-%p.profraw)
+    else ()
+        message(FATAL_ERROR "PGO is only set up for GCC and Clang")
+    endif ()
+elseif (CPU8080_PGO STREQUAL "USE")
+    if (CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+        # Profiles are matched by object path, so USE must be configured in the build tree that ran GENERATE.
+        add_compile_options(-fprofile-use=${CPU8080_PGO_DIR} -fprofile-partial-training -Wno-missing-profile)
+        add_link_options(-fprofile-use=${CPU8080_PGO_DIR})
+    elseif (CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+        set(profdata ${CPU8080_PGO_DIR}/cpu8080.profdata)
+        file(GLOB raw_profiles ${CPU8080_PGO_DIR}/*.profraw)
+        if (raw_profiles)
+            find_program(LLVM_PROFDATA NAMES llvm-profdata REQUIRED)
+            execute_process(COMMAND ${LLVM_PROFDATA} merge -output=${profdata} ${raw_profiles}
+                    COMMAND_ERROR_IS_FATAL ANY)
+        endif ()
+        if (NOT EXISTS ${profdata})
+            message(FATAL_ERROR "No profile in ${CPU8080_PGO_DIR}; run the GENERATE stage and pgo_train first")
+        endif ()
+        add_compile_options(-fprofile-instr-use=${profdata} -Wno-profile-instr-unprofiled)
+        add_link_options(-fprofile-instr-use=${profdata})
+    else ()
+        message(FATAL_ERROR "PGO is only set up for GCC and Clang")
+    endif ()
+elseif (CPU8080_PGO)
+    message(FATAL_ERROR "CPU8080_PGO must be OFF, GENERATE or USE")
+endif ()
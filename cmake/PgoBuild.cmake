@@ -0,0 +1,36 @@
+# Profile-guided release build, run in script mode:
+#   cmake -DSOURCE_DIR=<repo> -DBUILD_DIR=<build> [-DCXX_COMPILER=...] [-DARCH=native] [-DLTO=ON] -P cmake/PgoBuild.cmake
+#
+# Configures BUILD_DIR with instrumentation, runs pgo_train on the standard workloads, then
+# reconfigures the same tree to consume the profile and rebuilds everything.
+
+if (NOT SOURCE_DIR OR NOT BUILD_DIR)
+    message(FATAL_ERROR "SOURCE_DIR and BUILD_DIR are required")
+endif ()
+
+set(profile_dir ${BUILD_DIR}/pgo-data)
+set(common_args -S ${SOURCE_DIR} -B ${BUILD_DIR} -DCMAKE_BUILD_TYPE=Release -DCPU8080_PGO_DIR=${profile_dir})
+if (CXX_COMPILER)
+    list(APPEND common_args -DCMAKE_CXX_COMPILER=${CXX_COMPILER})
+endif ()
+list(APPEND common_args "-DCPU8080_ARCH=${ARCH}")
+if (LTO)
+    list(APPEND common_args -DCPU8080_LTO=${LTO})
+endif ()
+
+function(run)
+    execute_process(COMMAND ${ARGN} COMMAND_ERROR_IS_FATAL ANY)
+endfunction()
+
+file(REMOVE_RECURSE ${profile_dir})
+
+message(STATUS "PGO: instrumented build")
+run(${CMAKE_COMMAND} ${common_args} -DCPU8080_PGO=GENERATE)
+run(${CMAKE_COMMAND} --build ${BUILD_DIR} --target pgo_train)
+
+message(STATUS "PGO: training run")
+run(${BUILD_DIR}/bench/pgo_train)
+
+message(STATUS "PGO: optimized build")
+run(${CMAKE_COMMAND} ${common_args} -DCPU8080_PGO=USE)
+run(${CMAKE_COMMAND} --build ${BUILD_DIR})
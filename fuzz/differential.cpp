@@ -0,0 +1,249 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "differential.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include <disassembler.h>
+
+namespace {
+
+constexpr size_t maxProgramLength = 64;
+
+uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+void fillMemory(std::vector<Byte>& memory, FuzzCase const& fuzzCase) {
+    if (fuzzCase.memorySeed == 0) {
+        std::fill(memory.begin(), memory.end(), 0);
+    } else {
+        uint64_t state = fuzzCase.memorySeed;
+        for (size_t i = 0; i < memory.size(); i += 8) {
+            uint64_t const word = splitmix64(state);
+            std::memcpy(&memory[i], &word, 8);
+        }
+    }
+    for (size_t i = 0; i < fuzzCase.program.size(); ++i) {
+        memory[(uint16_t) (fuzzCase.pc + i)] = fuzzCase.program[i];
+    }
+}
+
+std::string hex(uint64_t value, int digits) {
+    char text[24];
+    std::snprintf(text, sizeof text, "%0*llx", digits, (unsigned long long) value);
+    return text;
+}
+
+template <typename T>
+void check(std::vector<std::string>& differences, char const* field, T emulator, T reference, int digits = 2) {
+    if (emulator != reference) {
+        differences.push_back(std::string(field) + ": emulator " + hex(emulator, digits) + " reference " + hex(reference, digits));
+    }
+}
+
+}
+
+FuzzCase FuzzCase::generate(std::mt19937_64& rng) {
+    FuzzCase fuzzCase;
+    uint64_t const registers = rng();
+    std::memcpy(fuzzCase.regs.data(), &registers, fuzzCase.regs.size());
+    uint64_t const more = rng();
+    fuzzCase.sp = more & 0xffff;
+    fuzzCase.pc = (more >> 16) & 0xffff;
+    fuzzCase.flags = ((more >> 32) & 0xd5) | 0x02;
+    fuzzCase.memorySeed = rng() | 1;
+    fuzzCase.program.resize(16 + (more >> 40) % (maxProgramLength - 15));
+    for (size_t i = 0; i < fuzzCase.program.size(); i += 8) {
+        uint64_t const word = rng();
+        std::memcpy(&fuzzCase.program[i], &word, std::min<size_t>(8, fuzzCase.program.size() - i));
+    }
+    fuzzCase.steps = fuzzCase.program.size();
+    return fuzzCase;
+}
+
+FuzzCase FuzzCase::fromBytes(Byte const* data, size_t size) {
+    FuzzCase fuzzCase;
+    Byte header[12] {};
+    std::memcpy(header, data, std::min(size, sizeof header));
+    std::copy(header, header + 7, fuzzCase.regs.begin());
+    fuzzCase.sp = header[7] | header[8] << 8;
+    fuzzCase.pc = header[9] | header[10] << 8;
+    fuzzCase.flags = (header[11] & 0xd5) | 0x02;
+    if (size > sizeof header) {
+        fuzzCase.program.assign(data + sizeof header, data + std::min(size, sizeof header + maxProgramLength));
+    }
+    fuzzCase.steps = fuzzCase.program.size();
+    return fuzzCase;
+}
+
+std::string FuzzCase::describe() const {
+    static char const names[] = "ABCDEHL";
+    std::string text;
+    for (size_t r = 0; r < regs.size(); ++r) {
+        text += std::string(1, names[r]) + "=" + hex(regs[r], 2) + " ";
+    }
+    text += "SP=" + hex(sp, 4) + " PC=" + hex(pc, 4) + " PSW flags=" + hex(flags, 2)
+            + " memory seed=" + hex(memorySeed, 16) + " steps=" + std::to_string(steps) + "\n";
+
+    std::vector<Byte> memory(1 << 16);
+    fillMemory(memory, *this);
+    Disassembler const disassembler;
+    char line[Disassembler::maxLineLength];
+    for (size_t offset = 0; offset < program.size();) {
+        char* cursor = line;
+        offset += disassembler.disassembleOp((uint16_t) (pc + offset), memory, cursor);
+        text.append(line, cursor);
+    }
+    return text;
+}
+
+std::string Divergence::describe() const {
+    std::string text = "diverged at step " + std::to_string(step) + ", op " + hex(opcode, 2) + " at " + hex(pc, 4) + "\n";
+    for (auto const& difference: differences) { text += "  " + difference + "\n"; }
+    return text;
+}
+
+void DifferentialRunner::load(FuzzCase const& fuzzCase) {
+    Status& status = emulator_.status_;
+    fillMemory(status.memory, fuzzCase);
+    reference_.memory = status.memory;
+
+    status.a = fuzzCase.regs[0];
+    status.b = fuzzCase.regs[1];
+    status.c = fuzzCase.regs[2];
+    status.d = fuzzCase.regs[3];
+    status.e = fuzzCase.regs[4];
+    status.h = fuzzCase.regs[5];
+    status.l = fuzzCase.regs[6];
+    status.sp = fuzzCase.sp;
+    status.pc = fuzzCase.pc;
+    status.cycles = 0;
+    status.is_interrupt_enabled = true;
+    emulator_.setPsw(fuzzCase.flags);
+
+    reference_.regs = {fuzzCase.regs[1], fuzzCase.regs[2], fuzzCase.regs[3], fuzzCase.regs[4],
+                       fuzzCase.regs[5], fuzzCase.regs[6], 0, fuzzCase.regs[0]};
+    reference_.sp = fuzzCase.sp;
+    reference_.pc = fuzzCase.pc;
+    reference_.cycles = 0;
+    reference_.interruptsEnabled = true;
+    reference_.s = fuzzCase.flags & 0x80;
+    reference_.z = fuzzCase.flags & 0x40;
+    reference_.ac = fuzzCase.flags & 0x10;
+    reference_.p = fuzzCase.flags & 0x04;
+    reference_.cy = fuzzCase.flags & 0x01;
+}
+
+void DifferentialRunner::compare(std::vector<std::string>& differences) const {
+    Status const& status = emulator_.status_;
+    ReferenceCpu const& ref = reference_;
+    check(differences, "A", status.a, ref.regs[ReferenceCpu::A]);
+    check(differences, "B", status.b, ref.regs[ReferenceCpu::B]);
+    check(differences, "C", status.c, ref.regs[ReferenceCpu::C]);
+    check(differences, "D", status.d, ref.regs[ReferenceCpu::D]);
+    check(differences, "E", status.e, ref.regs[ReferenceCpu::E]);
+    check(differences, "H", status.h, ref.regs[ReferenceCpu::H]);
+    check(differences, "L", status.l, ref.regs[ReferenceCpu::L]);
+    check(differences, "SP", status.sp, ref.sp, 4);
+    check(differences, "PC", status.pc, ref.pc, 4);
+    check(differences, "S", status.controls.s, ref.s, 1);
+    check(differences, "Z", status.controls.z, ref.z, 1);
+    check(differences, "AC", status.controls.ac, ref.ac, 1);
+    check(differences, "P", status.controls.p, ref.p, 1);
+    check(differences, "CY", status.controls.c, ref.cy, 1);
+    check(differences, "INTE", status.is_interrupt_enabled, ref.interruptsEnabled, 1);
+    check(differences, "cycles", status.cycles, ref.cycles, 1);
+    for (int i = 0; i < ref.writeCount; ++i) {
+        uint16_t const addr = ref.writes[i];
+        std::string const field = "memory[" + hex(addr, 4) + "]";
+        check(differences, field.c_str(), status.memory[addr], ref.memory[addr]);
+    }
+}
+
+std::optional<Divergence> DifferentialRunner::run(FuzzCase const& fuzzCase) {
+    load(fuzzCase);
+    Divergence divergence;
+    for (unsigned step = 0; step < fuzzCase.steps; ++step) {
+        divergence.step = step;
+        divergence.pc = reference_.pc;
+        divergence.opcode = reference_.memory[reference_.pc];
+        if (emulator_.emulateOp() != StopReason::NONE) { return std::nullopt; }
+        reference_.step();
+        compare(divergence.differences);
+        if (!divergence.differences.empty()) { return divergence; }
+    }
+
+    auto const& memory = emulator_.status_.memory;
+    auto const mismatch = std::mismatch(memory.begin(), memory.end(), reference_.memory.begin());
+    if (mismatch.first != memory.end()) {
+        std::string const field = "memory[" + hex(mismatch.first - memory.begin(), 4) + "]";
+        check(divergence.differences, field.c_str(), *mismatch.first, *mismatch.second);
+        return divergence;
+    }
+    return std::nullopt;
+}
+
+FuzzCase DifferentialRunner::minimize(FuzzCase fuzzCase) {
+    auto divergence = run(fuzzCase);
+    if (!divergence) { return fuzzCase; }
+
+    bool progress = true;
+    auto attempt = [&](FuzzCase const& candidate) {
+        if (auto found = run(candidate)) {
+            fuzzCase = candidate;
+            divergence = found;
+            progress = true;
+            return true;
+        }
+        return false;
+    };
+    while (progress) {
+        progress = false;
+        if (fuzzCase.steps > divergence->step + 1) {
+            FuzzCase candidate = fuzzCase;
+            candidate.steps = divergence->step + 1;
+            attempt(candidate);
+        }
+        if (fuzzCase.memorySeed != 0) {
+            FuzzCase candidate = fuzzCase;
+            candidate.memorySeed = 0;
+            attempt(candidate);
+        }
+        while (!fuzzCase.program.empty()) {
+            FuzzCase candidate = fuzzCase;
+            candidate.program.pop_back();
+            if (!attempt(candidate)) { break; }
+        }
+        for (size_t i = 0; i < fuzzCase.program.size(); ++i) {
+            if (fuzzCase.program[i] == 0x00) { continue; }
+            FuzzCase candidate = fuzzCase;
+            candidate.program[i] = 0x00;
+            attempt(candidate);
+        }
+        for (size_t r = 0; r < fuzzCase.regs.size(); ++r) {
+            if (fuzzCase.regs[r] == 0) { continue; }
+            FuzzCase candidate = fuzzCase;
+            candidate.regs[r] = 0;
+            attempt(candidate);
+        }
+        if (fuzzCase.sp != 0) {
+            FuzzCase candidate = fuzzCase;
+            candidate.sp = 0;
+            attempt(candidate);
+        }
+        if (fuzzCase.flags != 0x02) {
+            FuzzCase candidate = fuzzCase;
+            candidate.flags = 0x02;
+            attempt(candidate);
+        }
+    }
+    return fuzzCase;
+}
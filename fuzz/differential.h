@@ -0,0 +1,65 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_DIFFERENTIAL_H
+#define CPU8080_DIFFERENTIAL_H
+
+#include <array>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <emulator.h>
+
+#include "reference_cpu.h"
+
+// One differential test: a starting register file, memory filled from memorySeed (all zero when it
+// is 0) with program placed at pc, and the number of instructions to run in lockstep.
+struct FuzzCase {
+    std::array<Byte, 7> regs {};    // A, B, C, D, E, H, L
+    uint16_t sp {0};
+    uint16_t pc {0};
+    Byte flags {0x02};              // PSW layout: S Z 0 AC 0 P 1 CY
+    uint64_t memorySeed {0};
+    std::vector<Byte> program;
+    unsigned steps {0};
+
+    // A random case over the whole address space with a random program at pc.
+    static FuzzCase generate(std::mt19937_64& rng);
+    // Builds a case from arbitrary bytes, for coverage-guided fuzzers.
+    static FuzzCase fromBytes(Byte const* data, size_t size);
+    std::string describe() const;
+};
+
+struct Divergence {
+    unsigned step {0};              // Instructions completed before the diverging one.
+    uint16_t pc {0};
+    Byte opcode {0};
+    std::vector<std::string> differences;   // "<field>: emulator <x> reference <y>"
+
+    std::string describe() const;
+};
+
+// Runs cases on Emulator and ReferenceCpu side by side, reusing both between cases.
+class DifferentialRunner {
+public:
+    // Runs fuzzCase and returns where the cores first disagree, comparing registers, flags, cycles
+    // and written memory after every instruction and the whole memory at the end. Execution stops
+    // early, without a divergence, at HLT or an opcode Emulator does not implement.
+    std::optional<Divergence> run(FuzzCase const& fuzzCase);
+
+    // Greedily shrinks a diverging case (fewer steps, zeroed memory, a shorter program of NOPs,
+    // zeroed registers and flags) while it keeps diverging.
+    FuzzCase minimize(FuzzCase fuzzCase);
+
+private:
+    void load(FuzzCase const& fuzzCase);
+    void compare(std::vector<std::string>& differences) const;
+
+    Emulator emulator_;
+    ReferenceCpu reference_;
+};
+
+#endif //CPU8080_DIFFERENTIAL_H
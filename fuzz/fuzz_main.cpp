@@ -0,0 +1,78 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "differential.h"
+
+// fuzz [-j threads] [--runs N] [--seconds S] [--seed N]
+// Runs random cases until one diverges, N cases have run or S seconds have passed, whichever
+// comes first. A divergence is minimized and printed, and the exit status is 1.
+int main(int argc, char** argv) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t runs = 0;
+    double seconds = 10;
+    uint64_t seed = std::random_device{}();
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string const flag = argv[i];
+        if (flag == "-j") {
+            threads = std::stoul(argv[i + 1]);
+        } else if (flag == "--runs") {
+            runs = std::stoull(argv[i + 1]);
+            seconds = 0;
+        } else if (flag == "--seconds") {
+            seconds = std::stod(argv[i + 1]);
+        } else if (flag == "--seed") {
+            seed = std::stoull(argv[i + 1]);
+        } else {
+            std::cerr << "usage: fuzz [-j threads] [--runs N] [--seconds S] [--seed N]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::atomic<uint64_t> executed {0};
+    std::atomic<bool> stop {false};
+    std::mutex reportMutex;
+    bool diverged = false;
+    auto const start = std::chrono::steady_clock::now();
+    auto const deadline = start + std::chrono::duration<double>(seconds);
+
+    auto worker = [&](unsigned index) {
+        std::mt19937_64 rng(seed + index);
+        DifferentialRunner runner;
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (runs && executed.fetch_add(1, std::memory_order_relaxed) >= runs) { break; }
+            if (!runs) {
+                executed.fetch_add(1, std::memory_order_relaxed);
+                if ((executed.load(std::memory_order_relaxed) & 0xff) == 0 && std::chrono::steady_clock::now() > deadline) {
+                    break;
+                }
+            }
+            FuzzCase const fuzzCase = FuzzCase::generate(rng);
+            if (!runner.run(fuzzCase)) { continue; }
+
+            if (stop.exchange(true)) { break; }
+            FuzzCase const minimal = runner.minimize(fuzzCase);
+            std::lock_guard lock(reportMutex);
+            diverged = true;
+            std::cout << "original case:\n" << fuzzCase.describe()
+                      << "\nminimized case:\n" << minimal.describe() << '\n' << runner.run(minimal)->describe();
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < threads; ++i) { pool.emplace_back(worker, i); }
+    for (auto& thread: pool) { thread.join(); }
+
+    double const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t const total = runs ? std::min<uint64_t>(executed, runs) : executed.load();
+    std::cout << total << " cases on " << threads << " threads in " << elapsed << " s ("
+              << static_cast<uint64_t>(total / elapsed) << " cases/s), seed " << seed << std::endl;
+    return diverged ? 1 : 0;
+}
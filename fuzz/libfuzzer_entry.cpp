@@ -0,0 +1,22 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "differential.h"
+
+// Coverage-guided entry point: clang -fsanitize=fuzzer. libFuzzer minimizes crashing inputs itself
+// with -minimize_crash=1; the minimized case printed here is the greedy structural one.
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size) {
+    static DifferentialRunner runner;
+    FuzzCase const fuzzCase = FuzzCase::fromBytes(data, size);
+    if (auto divergence = runner.run(fuzzCase)) {
+        std::fprintf(stderr, "%s%s", fuzzCase.describe().c_str(), divergence->describe().c_str());
+        FuzzCase const minimal = runner.minimize(fuzzCase);
+        std::fprintf(stderr, "minimized case:\n%s", minimal.describe().c_str());
+        std::abort();
+    }
+    return 0;
+}
@@ -0,0 +1,316 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "reference_cpu.h"
+
+namespace {
+
+// States per opcode from the 8080 data sheet; conditional CALL/RET add 6 when taken.
+constexpr uint8_t cycleTable[256] = {
+    4, 10,  7,  5,  5,  5,  7,  4,  4, 10,  7,  5,  5,  5,  7,  4,
+    4, 10,  7,  5,  5,  5,  7,  4,  4, 10,  7,  5,  5,  5,  7,  4,
+    4, 10, 16,  5,  5,  5,  7,  4,  4, 10, 16,  5,  5,  5,  7,  4,
+    4, 10, 13,  5, 10, 10, 10,  4,  4, 10, 13,  5,  5,  5,  7,  4,
+    5,  5,  5,  5,  5,  5,  7,  5,  5,  5,  5,  5,  5,  5,  7,  5,
+    5,  5,  5,  5,  5,  5,  7,  5,  5,  5,  5,  5,  5,  5,  7,  5,
+    5,  5,  5,  5,  5,  5,  7,  5,  5,  5,  5,  5,  5,  5,  7,  5,
+    7,  7,  7,  7,  7,  7,  7,  7,  5,  5,  5,  5,  5,  5,  7,  5,
+    4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+    4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+    4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+    4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+    5, 10, 10, 10, 11, 11,  7, 11,  5, 10, 10, 10, 11, 17,  7, 11,
+    5, 10, 10, 10, 11, 11,  7, 11,  5, 10, 10, 10, 11, 17,  7, 11,
+    5, 10, 10, 18, 11, 11,  7, 11,  5,  5, 10,  4, 11, 17,  7, 11,
+    5, 10, 10,  4, 11, 11,  7, 11,  5,  5, 10,  4, 11, 17,  7, 11,
+};
+
+bool evenParity(Byte value) {
+    bool even = true;
+    for (int bit = 0; bit < 8; ++bit) {
+        if (value & (1 << bit)) { even = !even; }
+    }
+    return even;
+}
+
+}
+
+Byte ReferenceCpu::fetch() {
+    return read(pc++);
+}
+
+uint16_t ReferenceCpu::fetchWord() {
+    Byte const low = fetch();
+    return fetch() << 8 | low;
+}
+
+Byte ReferenceCpu::read(uint16_t addr) const {
+    return memory[addr];
+}
+
+void ReferenceCpu::write(uint16_t addr, Byte value) {
+    memory[addr] = value;
+    writes[writeCount++] = addr;
+}
+
+Byte ReferenceCpu::reg(int r) const {
+    return r == M ? read(pair(2)) : regs[r];
+}
+
+void ReferenceCpu::setReg(int r, Byte value) {
+    if (r == M) {
+        write(pair(2), value);
+    } else {
+        regs[r] = value;
+    }
+}
+
+// Register pairs as encoded by the rp field: BC, DE, HL, SP.
+uint16_t ReferenceCpu::pair(int rp) const {
+    return rp == 3 ? sp : regs[2 * rp] << 8 | regs[2 * rp + 1];
+}
+
+void ReferenceCpu::setPair(int rp, uint16_t value) {
+    if (rp == 3) {
+        sp = value;
+    } else {
+        regs[2 * rp] = value >> 8;
+        regs[2 * rp + 1] = value & 0xff;
+    }
+}
+
+void ReferenceCpu::push(uint16_t value) {
+    write(--sp, value >> 8);
+    write(--sp, value & 0xff);
+}
+
+uint16_t ReferenceCpu::pop() {
+    Byte const low = read(sp++);
+    return read(sp++) << 8 | low;
+}
+
+// NZ, Z, NC, C, PO, PE, P, M
+bool ReferenceCpu::condition(int cc) const {
+    bool const flags[4] = {z, cy, p, s};
+    return flags[cc >> 1] == (cc & 1);
+}
+
+void ReferenceCpu::setZsp(Byte value) {
+    z = value == 0;
+    s = value >> 7;
+    p = evenParity(value);
+}
+
+// ADD, ADC, SUB, SBB, ANA, XRA, ORA, CMP. Subtraction is addition of the complement with the
+// borrow inverted, which is how the 8080 derives AC and CY for it.
+void ReferenceCpu::alu(int operation, Byte operand) {
+    Byte const a = regs[A];
+    switch (operation) {
+        case 0: case 1: case 2: case 3: case 7: {
+            bool const subtract = operation >= 2;
+            bool const carryIn = (operation == 1 && cy) || (operation == 3 && !cy) || operation == 2 || operation == 7;
+            Byte const addend = subtract ? ~operand : operand;
+            unsigned const sum = a + addend + carryIn;
+            ac = ((a ^ addend ^ sum) & 0x10) != 0;
+            cy = (sum > 0xff) != subtract;
+            setZsp(sum & 0xff);
+            if (operation != 7) { regs[A] = sum & 0xff; }
+            break;
+        }
+        case 4: {
+            ac = ((a | operand) & 0x08) != 0;
+            regs[A] = a & operand;
+            cy = false;
+            setZsp(regs[A]);
+            break;
+        }
+        default: {
+            regs[A] = operation == 5 ? a ^ operand : a | operand;
+            ac = false;
+            cy = false;
+            setZsp(regs[A]);
+            break;
+        }
+    }
+}
+
+// RLC, RRC, RAL, RAR, DAA, CMA, STC, CMC
+void ReferenceCpu::rotateOrFlag(int operation) {
+    Byte& a = regs[A];
+    switch (operation) {
+        case 0: cy = a >> 7; a = a << 1 | cy; break;
+        case 1: cy = a & 1; a = a >> 1 | cy << 7; break;
+        case 2: { bool const out = a >> 7; a = a << 1 | cy; cy = out; break; }
+        case 3: { bool const out = a & 1; a = a >> 1 | cy << 7; cy = out; break; }
+        case 4: {
+            Byte adjust = 0;
+            bool carry = cy;
+            if ((a & 0x0f) > 9 || ac) { adjust += 0x06; }
+            if ((a >> 4) > 9 || cy || ((a >> 4) == 9 && (a & 0x0f) > 9)) {
+                adjust += 0x60;
+                carry = true;
+            }
+            unsigned const sum = a + adjust;
+            ac = ((a ^ adjust ^ sum) & 0x10) != 0;
+            a = sum & 0xff;
+            cy = carry;
+            setZsp(a);
+            break;
+        }
+        case 5: a = ~a; break;
+        case 6: cy = true; break;
+        default: cy = !cy; break;
+    }
+}
+
+void ReferenceCpu::step() {
+    writeCount = 0;
+    Byte const op = fetch();
+    cycles += cycleTable[op];
+    int const x = op >> 6;
+    int const y = (op >> 3) & 7;
+    int const z = op & 7;
+    int const rp = y >> 1;
+    bool const q = y & 1;
+
+    switch (x) {
+        case 0:
+            switch (z) {
+                case 0: break;
+                case 1: {
+                    if (q) {
+                        unsigned const sum = pair(2) + pair(rp);
+                        cy = sum > 0xffff;
+                        setPair(2, sum & 0xffff);
+                    } else {
+                        setPair(rp, fetchWord());
+                    }
+                    break;
+                }
+                case 2: {
+                    if (y < 4) {
+                        uint16_t const addr = pair(rp);
+                        if (q) { regs[A] = read(addr); } else { write(addr, regs[A]); }
+                        break;
+                    }
+                    uint16_t const addr = fetchWord();
+                    switch (y) {
+                        case 4: write(addr, regs[L]); write(addr + 1, regs[H]); break;
+                        case 5: regs[L] = read(addr); regs[H] = read(addr + 1); break;
+                        case 6: write(addr, regs[A]); break;
+                        default: regs[A] = read(addr); break;
+                    }
+                    break;
+                }
+                case 3: setPair(rp, pair(rp) + (q ? -1 : 1)); break;
+                case 4: {
+                    Byte const value = reg(y) + 1;
+                    setReg(y, value);
+                    setZsp(value);
+                    ac = (value & 0x0f) == 0x00;
+                    break;
+                }
+                case 5: {
+                    Byte const value = reg(y) - 1;
+                    setReg(y, value);
+                    setZsp(value);
+                    ac = (value & 0x0f) != 0x0f;
+                    break;
+                }
+                case 6: setReg(y, fetch()); break;
+                default: rotateOrFlag(y); break;
+            }
+            break;
+        case 1:
+            // 0x76 is HLT; callers stop before it, so it is never decoded as MOV M,M here.
+            setReg(y, reg(z));
+            break;
+        case 2:
+            alu(y, reg(z));
+            break;
+        default:
+            switch (z) {
+                case 0: {
+                    if (condition(y)) {
+                        cycles += 6;
+                        pc = pop();
+                    }
+                    break;
+                }
+                case 1: {
+                    if (!q) {
+                        uint16_t const value = pop();
+                        if (rp == 3) {
+                            regs[A] = value >> 8;
+                            cy = value & 0x01;
+                            p = value & 0x04;
+                            ac = value & 0x10;
+                            this->z = value & 0x40;
+                            s = value & 0x80;
+                        } else {
+                            setPair(rp, value);
+                        }
+                        break;
+                    }
+                    switch (rp) {
+                        case 0: case 1: pc = pop(); break;
+                        case 2: pc = pair(2); break;
+                        default: sp = pair(2); break;
+                    }
+                    break;
+                }
+                case 2: {
+                    uint16_t const target = fetchWord();
+                    if (condition(y)) { pc = target; }
+                    break;
+                }
+                case 3: {
+                    switch (y) {
+                        case 0: case 1: pc = fetchWord(); break;
+                        case 2: case 3: fetch(); break;     // OUT and IN: no devices are attached.
+                        case 4: {
+                            uint16_t const top = read(sp) | read(sp + 1) << 8;
+                            write(sp, regs[L]);
+                            write(sp + 1, regs[H]);
+                            setPair(2, top);
+                            break;
+                        }
+                        case 5: {
+                            uint16_t const de = pair(1);
+                            setPair(1, pair(2));
+                            setPair(2, de);
+                            break;
+                        }
+                        case 6: interruptsEnabled = false; break;
+                        default: interruptsEnabled = true; break;
+                    }
+                    break;
+                }
+                case 4: {
+                    uint16_t const target = fetchWord();
+                    if (condition(y)) {
+                        cycles += 6;
+                        push(pc);
+                        pc = target;
+                    }
+                    break;
+                }
+                case 5: {
+                    if (q) {
+                        uint16_t const target = fetchWord();
+                        push(pc);
+                        pc = target;
+                    } else if (rp == 3) {
+                        push(regs[A] << 8 | s << 7 | this->z << 6 | ac << 4 | p << 2 | 0x02 | cy);
+                    } else {
+                        push(pair(rp));
+                    }
+                    break;
+                }
+                case 6: alu(y, fetch()); break;
+                default: push(pc); pc = y * 8; break;
+            }
+            break;
+    }
+}
@@ -0,0 +1,58 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_REFERENCE_CPU_H
+#define CPU8080_REFERENCE_CPU_H
+
+#include <array>
+#include <stdint.h>
+#include <vector>
+
+#include <types.h>
+
+// A second 8080 core written from the data sheet, independently of Emulator, for differential
+// fuzzing. It decodes the x/y/z opcode fields instead of switching on all 256 opcodes, takes its
+// timing from its own table and derives flags with different formulas, so a mistake has to be
+// made twice to go unnoticed. Speed is not a goal.
+class ReferenceCpu {
+public:
+    // Register indices in the order of the 3-bit operand field; 6 is the memory operand M.
+    enum Register { B, C, D, E, H, L, M, A };
+
+    std::array<Byte, 8> regs {};
+    uint16_t sp {0};
+    uint16_t pc {0};
+    bool s {false};
+    bool z {false};
+    bool ac {false};
+    bool p {false};
+    bool cy {false};
+    bool interruptsEnabled {true};
+    uint64_t cycles {0};
+    std::vector<Byte> memory = std::vector<Byte>(1 << 16, 0);
+
+    // Addresses written by the last step, so callers can compare memory without scanning all of it.
+    std::array<uint16_t, 2> writes {};
+    int writeCount {0};
+
+    void step();
+
+private:
+    Byte fetch();
+    uint16_t fetchWord();
+    Byte read(uint16_t addr) const;
+    void write(uint16_t addr, Byte value);
+    Byte reg(int r) const;
+    void setReg(int r, Byte value);
+    uint16_t pair(int rp) const;
+    void setPair(int rp, uint16_t value);
+    void push(uint16_t value);
+    uint16_t pop();
+    bool condition(int cc) const;
+    void setZsp(Byte value);
+    void alu(int operation, Byte operand);
+    void rotateOrFlag(int operation);
+};
+
+#endif //CPU8080_REFERENCE_CPU_H
@@ -0,0 +1,106 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "cpm.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "rom.h"
+
+namespace cpm {
+
+namespace {
+
+void bdosCall(Status const& status, std::string& output, std::function<void(char)> const& echo) {
+    auto put = [&](char c) {
+        output += c;
+        if (echo) { echo(c); }
+    };
+    switch (status.c) {
+        case 2: { // C_WRITE
+            put(status.e);
+            break;
+        }
+        case 9: { // C_WRITESTR
+            uint16_t addr = status.de;
+            for (size_t n = 0; n < addressSpaceSize && status.memory[addr] != '$'; ++n, ++addr) {
+                put(status.memory[addr]);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+}
+
+RunResult run(Emulator& emulator, std::span<Byte const> program, uint64_t maxCycles,
+              std::function<void(char)> const& echo) {
+    Status& status = emulator.status_;
+    if (program.size() > bdosBase - programBase) {
+        throw RomLoadError("CP/M program of " + std::to_string(program.size()) + " bytes does not fit below the BDOS");
+    }
+    std::fill(status.memory.begin(), status.memory.end(), 0);
+    std::copy(program.begin(), program.end(), status.memory.begin() + programBase);
+    status.memory[0x0000] = 0x76;               // HLT, never reached: the warm boot ends the run first.
+    status.memory[bdosEntry] = 0xc3;            // JMP bdosBase
+    status.memory[bdosEntry + 1] = bdosBase & 0xff;
+    status.memory[bdosEntry + 2] = bdosBase >> 8;
+    status.memory[bdosBase] = 0xc9;             // RET
+    status.pc = programBase;
+    status.sp = bdosBase;
+    status.cycles = 0;
+
+    RunResult result;
+    auto const start = std::chrono::steady_clock::now();
+    result.stop = {StopReason::CYCLE_BUDGET};
+    while (status.cycles < maxCycles) {
+        if (status.pc == 0x0000) {
+            result.finished = true;
+            result.stop = {};
+            break;
+        }
+        if (status.pc == bdosEntry) { bdosCall(status, result.output, echo); }
+        if (emulator.emulateOp() != StopReason::NONE) {
+            result.stop = emulator.lastStop();
+            break;
+        }
+        ++result.instructions;
+    }
+    if (result.stop.reason == StopReason::CYCLE_BUDGET) {
+        result.stop.pc = status.pc;
+        result.stop.opcode = status.memory[status.pc];
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.cycles = status.cycles;
+    return result;
+}
+
+std::vector<TestGroup> parseGroups(std::string_view output) {
+    std::vector<TestGroup> groups;
+    while (!output.empty()) {
+        size_t const end = std::min(output.find('\n'), output.size());
+        std::string_view line = output.substr(0, end);
+        output.remove_prefix(std::min(end + 1, output.size()));
+
+        size_t const pass = line.find("PASS!");
+        size_t const error = line.find("ERROR");
+        size_t const verdict = std::min(pass, error);
+        if (verdict == std::string_view::npos) { continue; }
+
+        std::string_view name = line.substr(0, verdict);
+        while (!name.empty() && (name.back() == '.' || name.back() == ' ')) { name.remove_suffix(1); }
+        std::string_view detail = line.substr(verdict + 5);
+        while (!detail.empty() && std::string_view(" *\r").find(detail.front()) != std::string_view::npos) {
+            detail.remove_prefix(1);
+        }
+        while (!detail.empty() && (detail.back() == '\r' || detail.back() == ' ')) { detail.remove_suffix(1); }
+        groups.push_back({std::string(name), pass < error, std::string(detail)});
+    }
+    return groups;
+}
+
+}
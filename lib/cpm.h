@@ -0,0 +1,51 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_CPM_H
+#define CPU8080_CPM_H
+
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "emulator.h"
+
+// Just enough CP/M to run the 8080 exercisers (TST8080, CPUTEST, 8080PRE, 8080EXM): the program is
+// loaded at $0100, CALL 5 is trapped for console output (functions 2 and 9) and jumping to $0000,
+// the warm boot, ends the run.
+namespace cpm {
+
+constexpr uint16_t programBase = 0x0100;
+constexpr uint16_t bdosEntry = 0x0005;
+constexpr uint16_t bdosBase = 0xfe00;   // Top of the TPA, read by programs from $0006 to set up their stack.
+
+struct RunResult {
+    std::string output;
+    uint64_t instructions {0};
+    uint64_t cycles {0};
+    double seconds {0};
+    bool finished {false};  // False when maxCycles ran out or the program stopped before the warm boot.
+    Stop stop;              // Why a run that did not finish ended.
+};
+
+// One "<group>.... PASS!/ERROR" line of exerciser output.
+struct TestGroup {
+    std::string name;
+    bool passed {false};
+    std::string detail;     // The crc text after PASS!/ERROR.
+};
+
+// Runs program to the warm boot or until maxCycles states have elapsed. Every console character
+// is also passed to echo when it is set, so long runs show their progress.
+RunResult run(Emulator& emulator, std::span<Byte const> program, uint64_t maxCycles = UINT64_MAX,
+              std::function<void(char)> const& echo = {});
+
+// Splits exerciser output into its instruction groups; lines without PASS! or ERROR are skipped.
+std::vector<TestGroup> parseGroups(std::string_view output);
+
+}
+
+#endif //CPU8080_CPM_H
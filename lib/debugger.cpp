@@ -0,0 +1,177 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "debugger.h"
+
+#include <algorithm>
+
+#include "emulator.h"
+
+namespace {
+
+struct Access {
+    uint16_t address;
+    uint8_t length;
+    uint8_t kind;
+};
+
+// NZ, Z, NC, C, PO, PE, P, M
+bool condition(Controls const& controls, int cc) {
+    bool const flags[4] = {controls.z, controls.c, controls.p, controls.s};
+    return flags[cc >> 1] == (cc & 1);
+}
+
+// The data memory the op at status.pc is about to touch, if any; instruction fetches do not count.
+bool access(Status const& status, Access& out) {
+    auto const& mem = status.memory;
+    Byte const op = mem[status.pc];
+    uint16_t const addr = mem[(uint16_t) (status.pc + 1)] | mem[(uint16_t) (status.pc + 2)] << 8;
+    uint16_t const hl = status.hl;
+    uint16_t const pushed = status.sp - 2;
+    int const x = op >> 6;
+    int const y = (op >> 3) & 7;
+    int const z = op & 7;
+
+    switch (x) {
+        case 0:
+            if (z == 2) {
+                switch (y) {
+                    case 0: out = {status.bc, 1, WATCH_WRITE}; return true;
+                    case 1: out = {status.bc, 1, WATCH_READ}; return true;
+                    case 2: out = {status.de, 1, WATCH_WRITE}; return true;
+                    case 3: out = {status.de, 1, WATCH_READ}; return true;
+                    case 4: out = {addr, 2, WATCH_WRITE}; return true;
+                    case 5: out = {addr, 2, WATCH_READ}; return true;
+                    case 6: out = {addr, 1, WATCH_WRITE}; return true;
+                    default: out = {addr, 1, WATCH_READ}; return true;
+                }
+            }
+            if (y == 6 && (z == 4 || z == 5)) { out = {hl, 1, WATCH_ACCESS}; return true; }
+            if (y == 6 && z == 6) { out = {hl, 1, WATCH_WRITE}; return true; }
+            return false;
+        case 1:
+            if (op == 0x76) { return false; }
+            if (z == 6) { out = {hl, 1, WATCH_READ}; return true; }
+            if (y == 6) { out = {hl, 1, WATCH_WRITE}; return true; }
+            return false;
+        case 2:
+            if (z == 6) { out = {hl, 1, WATCH_READ}; return true; }
+            return false;
+        default:
+            switch (z) {
+                case 0:
+                    if (!condition(status.controls, y)) { return false; }
+                    out = {status.sp, 2, WATCH_READ};
+                    return true;
+                case 1:
+                    if ((y & 1) && y >= 4) { return false; }   // PCHL, SPHL
+                    out = {status.sp, 2, WATCH_READ};           // POP, RET
+                    return true;
+                case 3:
+                    if (y != 4) { return false; }
+                    out = {status.sp, 2, WATCH_ACCESS};         // XTHL
+                    return true;
+                case 4:
+                    if (!condition(status.controls, y)) { return false; }
+                    out = {pushed, 2, WATCH_WRITE};
+                    return true;
+                case 5:
+                case 7:
+                    out = {pushed, 2, WATCH_WRITE};             // PUSH, CALL, RST
+                    return true;
+                default:
+                    return false;
+            }
+    }
+}
+
+}
+
+void Debugger::addBreakpoint(uint16_t pc) {
+    if (breakpointAt(pc)) { return; }
+    pcBits_[pc >> 6] |= uint64_t {1} << (pc & 63);
+    ++breakpoints_;
+}
+
+void Debugger::removeBreakpoint(uint16_t pc) {
+    if (!breakpointAt(pc)) { return; }
+    pcBits_[pc >> 6] &= ~(uint64_t {1} << (pc & 63));
+    --breakpoints_;
+}
+
+void Debugger::addWatchpoint(uint16_t address, uint16_t length, uint8_t kind) {
+    if (length == 0 || (kind & WATCH_ACCESS) == 0) { return; }
+    watchpoints_.push_back({address, length, kind});
+    update();
+}
+
+void Debugger::removeWatchpoint(uint16_t address, uint16_t length, uint8_t kind) {
+    auto const end = std::remove_if(watchpoints_.begin(), watchpoints_.end(), [&](Watchpoint const& w) {
+        return w.address == address && w.length == length && w.kind == kind;
+    });
+    watchpoints_.erase(end, watchpoints_.end());
+    update();
+}
+
+int Debugger::addCondition(std::function<bool(Status const&)> condition) {
+    conditions_.push_back({nextConditionId_, std::move(condition)});
+    update();
+    return nextConditionId_++;
+}
+
+void Debugger::removeCondition(int id) {
+    auto const end = std::remove_if(conditions_.begin(), conditions_.end(), [&](Condition const& c) { return c.id == id; });
+    conditions_.erase(end, conditions_.end());
+    update();
+}
+
+void Debugger::clear() {
+    pcBits_.fill(0);
+    breakpoints_ = 0;
+    watchpoints_.clear();
+    conditions_.clear();
+    update();
+}
+
+void Debugger::update() {
+    pageKinds_.fill(0);
+    for (auto const& w: watchpoints_) {
+        for (uint32_t offset = 0; offset < w.length; offset += 256) {
+            pageKinds_[(uint16_t) (w.address + offset) >> 8] |= w.kind;
+        }
+        pageKinds_[(uint16_t) (w.address + w.length - 1) >> 8] |= w.kind;
+    }
+    slowChecks_ = !watchpoints_.empty() || !conditions_.empty();
+}
+
+uint8_t Debugger::watcher(uint16_t address, uint8_t kind) const {
+    if ((pageKinds_[address >> 8] & kind) == 0) { return 0; }
+    auto const found = std::find_if(watchpoints_.begin(), watchpoints_.end(), [&](Watchpoint const& w) {
+        return (w.kind & kind) && (uint16_t) (address - w.address) < w.length;
+    });
+    return found == watchpoints_.end() ? 0 : found->kind;
+}
+
+bool Debugger::check(Status const& status, Stop& stop) const {
+    Stop hit {StopReason::NONE, status.pc, status.memory[status.pc]};
+    if (breakpointAt(status.pc)) {
+        hit.reason = StopReason::BREAKPOINT;
+    } else if (Access found; !watchpoints_.empty() && access(status, found)) {
+        for (int offset = 0; offset < found.length && hit.reason == StopReason::NONE; ++offset) {
+            uint16_t const address = found.address + offset;
+            if (uint8_t const kind = watcher(address, found.kind)) {
+                hit.reason = StopReason::WATCHPOINT;
+                hit.address = address;
+                hit.watchKind = kind;
+            }
+        }
+    }
+    if (hit.reason == StopReason::NONE
+            && std::any_of(conditions_.begin(), conditions_.end(), [&](Condition const& c) { return c.predicate(status); })) {
+        hit.reason = StopReason::CONDITION;
+    }
+    if (hit.reason == StopReason::NONE) { return false; }
+    stop = hit;
+    return true;
+}
@@ -0,0 +1,73 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_DEBUGGER_H
+#define CPU8080_DEBUGGER_H
+
+#include <array>
+#include <functional>
+#include <stdint.h>
+#include <vector>
+
+#include "types.h"
+
+class Status;
+struct Stop;
+
+enum WatchKind : uint8_t {
+    WATCH_READ = 1,
+    WATCH_WRITE = 2,
+    WATCH_ACCESS = WATCH_READ | WATCH_WRITE,
+};
+
+// Breakpoints on PC, watchpoints on memory ranges and conditions on the registers. Emulator::run
+// switches to its checking loop while any of them is set. A breakpoint costs one bit test per op;
+// the memory an op is about to touch is only worked out while watchpoints exist, and only ops that
+// touch a page with a watchpoint on it look at the watchpoint list.
+class Debugger {
+public:
+    void addBreakpoint(uint16_t pc);
+    void removeBreakpoint(uint16_t pc);
+    bool breakpointAt(uint16_t pc) const { return (pcBits_[pc >> 6] >> (pc & 63)) & 1; }
+
+    // Stops before any op that reads (WATCH_READ) or writes (WATCH_WRITE) a byte of the range.
+    void addWatchpoint(uint16_t address, uint16_t length, uint8_t kind);
+    void removeWatchpoint(uint16_t address, uint16_t length, uint8_t kind);
+
+    // Stops before any op for which condition holds. Returns an id for removeCondition.
+    int addCondition(std::function<bool(Status const&)> condition);
+    void removeCondition(int id);
+
+    void clear();
+    bool active() const { return breakpoints_ != 0 || slowChecks_; }
+    bool slowChecks() const { return slowChecks_; }
+
+    // Whether the op at status.pc should not run; fills stop when it should not.
+    bool check(Status const& status, Stop& stop) const;
+
+private:
+    struct Watchpoint {
+        uint16_t address;
+        uint16_t length;
+        uint8_t kind;
+    };
+    struct Condition {
+        int id;
+        std::function<bool(Status const&)> predicate;
+    };
+
+    // The kind of the first watchpoint over address that watches kind; 0 when there is none.
+    uint8_t watcher(uint16_t address, uint8_t kind) const;
+    void update();
+
+    std::array<uint64_t, (1 << 16) / 64> pcBits_ {};
+    size_t breakpoints_ {0};
+    std::vector<Watchpoint> watchpoints_;
+    std::array<uint8_t, 256> pageKinds_ {};     // The kinds watched anywhere in each 256-byte page.
+    std::vector<Condition> conditions_;
+    int nextConditionId_ {0};
+    bool slowChecks_ {false};
+};
+
+#endif //CPU8080_DEBUGGER_H
@@ -4,22 +4,40 @@
 
 #ifndef CPU8080_DISASSEMBLER_H
 #define CPU8080_DISASSEMBLER_H
-#include <fstream>
-#include <iostream>
+#include <span>
+#include <string>
 #include <vector>
 
 #include "types.h"
 
-class Disassembler {
-public:
-    std::vector<Byte> getBytesFromFile(std::string const& filename);
-    void disassembleFile(std::string const& filename);
-    int disassembleOp(uint16_t pc, std::vector<Byte> const& ops) const;
+struct BulkReport {
+    size_t images {0};
+    uint64_t bytes {0};
+    double seconds {0};
+    std::vector<std::string> errors;
 
+    double megabytesPerSecond() const { return seconds > 0 ? bytes / seconds / 1e6 : 0; }
+};
 
-private:
-    std::ifstream stream_;
-    uint32_t pc_;
+// Holds no state, so one instance can be shared by any number of threads.
+class Disassembler {
+public:
+    // Room disassembleOp needs for one line: address, tab, the whole mnemonic field, four digits
+    // and a newline, since it copies fixed-size chunks before trimming.
+    static constexpr size_t maxLineLength = 32;
+
+    // Expands directories in paths to the regular files they contain, sorted by name.
+    static std::vector<std::string> collectImages(std::vector<std::string> const& paths);
+
+    void disassembleFile(std::string const& filename) const;
+    // Shards images across threads workers and writes each listing to <outputDirectory>/<image name>.asm,
+    // or <image name>.<n>.asm for the nth image in the list with a name taken already.
+    BulkReport disassembleBulk(std::vector<std::string> const& images, std::string const& outputDirectory,
+                               unsigned threads) const;
+    std::string disassemble(std::span<Byte const> ops) const;
+    // Writes the line for the op at pc to out (at least maxLineLength bytes), advances out past it
+    // and returns the number of bytes in the op.
+    int disassembleOp(uint16_t pc, std::span<Byte const> ops, char*& out) const;
 
 };
 
@@ -1,28 +1,130 @@
 //
 // Created by KarlE on 2/13/2023.
 //
+#include <array>
+#include <cstdio>
+#include <iomanip>
 #include <iostream>
+#include <utility>
 #include "emulator.h"
 #include "auxiliary.h"
+#include "opcodes.h"
+#include "rom.h"
+#include "superinstructions.h"
 
-NotImplementedInstruction::NotImplementedInstruction(uint8_t opcode): opcode_{opcode} {}
-const char* NotImplementedInstruction::what() const noexcept {
-    return "Instruction not implemented";
+namespace {
+
+// Carry out of bit 3 when adding the low nibbles; subtraction passes ~operand and !borrow.
+constexpr bool auxCarry(Byte a, Byte b, bool carry) {
+    return (a & 0x0f) + (b & 0x0f) + carry > 0x0f;
+}
+
+// DAA for every (AC, CY, A), indexed by AC << 9 | CY << 8 | A. The low byte is the adjusted
+// accumulator and the high byte the flags it leaves, laid out as in the PSW.
+constexpr std::array<uint16_t, 1024> daaTable = [] {
+    std::array<uint16_t, 1024> table {};
+    for (unsigned index = 0; index < table.size(); ++index) {
+        Byte const a = index & 0xff;
+        bool const cy = index & 0x100;
+        bool const ac = index & 0x200;
+        Byte correction = 0;
+        bool carry = cy;
+        if (ac || (a & 0x0f) > 9) { correction |= 0x06; }
+        if (cy || (a >> 4) > 9 || ((a >> 4) >= 9 && (a & 0x0f) > 9)) {
+            correction |= 0x60;
+            carry = true;
+        }
+        Byte const result = a + correction;
+        Byte const flags = (result & 0x80) | (result == 0) << 6 | auxCarry(a, correction, false) << 4
+                           | (popcount(result) % 2 == 0) << 2 | 0x02 | carry;
+        table[index] = flags << 8 | result;
+    }
+    return table;
+}();
+
+}
+
+char const* toString(StopReason reason) {
+    switch (reason) {
+        case StopReason::NONE: return "none";
+        case StopReason::CYCLE_BUDGET: return "cycle budget used up";
+        case StopReason::HALTED: return "halted";
+        case StopReason::UNIMPLEMENTED_OPCODE: return "unimplemented opcode";
+        case StopReason::BREAKPOINT: return "breakpoint";
+        case StopReason::WATCHPOINT: return "watchpoint";
+        case StopReason::CONDITION: return "condition";
+    }
+    return "unknown";
+}
+
+std::string Stop::describe() const {
+    char text[80];
+    int length = std::snprintf(text, sizeof text, "%s at $%04x (opcode %02x)", toString(reason), pc, opcode);
+    if (reason == StopReason::WATCHPOINT) {
+        std::snprintf(text + length, sizeof text - length, " on $%04x", address);
+    }
+    return text;
+}
+
+void Emulator::setUnimplementedPolicy(UnimplementedPolicy policy, UnimplementedHandler handler) {
+    unimplementedPolicy_ = policy;
+    unimplementedHandler_ = std::move(handler);
+}
+
+// Applies the policy to op at pc, with status_.pc and cycles already advanced past it.
+StopReason Emulator::unimplemented(uint16_t pc, Byte op) {
+    Stop const stop {StopReason::UNIMPLEMENTED_OPCODE, pc, op};
+    ++unimplementedHits_;
+    if (unimplementedPolicy_ == UnimplementedPolicy::NOP) { return StopReason::NONE; }
+    if (unimplementedPolicy_ == UnimplementedPolicy::CALLBACK && unimplementedHandler_ && unimplementedHandler_(*this, stop)) {
+        return StopReason::NONE;
+    }
+    status_.pc = pc;
+    status_.cycles -= opcodes[op].cycles;
+    stop_ = stop;
+    return StopReason::UNIMPLEMENTED_OPCODE;
 }
 
 void Emulator::setMemory(const std::string &filename) {
-    getBytesFromFile(filename, &status_.memory[0]);
+    setMemory(std::vector<RomPart>{{filename, 0}});
+}
+
+void Emulator::setMemory(std::vector<RomPart> const& parts) {
+    loadRom(parts, status_.memory);
+    idioms_.forget();
 }
 
 void Emulator::emulate() {
-    while (status_.pc < status_.memory.size()) {
+    do {
 //        std::cout << status_ << std::endl;
         std::cout << std::hex << std::setw(2) << std::setfill('0') << (int) status_.pc << ' ';
-        emulateOp();
-    }
+    } while (emulateOp() == StopReason::NONE);
+    std::cout << std::dec << '\n' << stop_.describe() << std::endl;
+}
+
+bool Emulator::interrupt(Byte vector) {
+    if (!status_.is_interrupt_enabled) { return false; }
+    if (interruptListener_) { interruptListener_(status_.cycles, vector); }
+    status_.is_interrupt_enabled = false;
+    status_.cycles += opcodes[0xc7].cycles;
+    call(vector * 8);
+    return true;
 }
 
-void Emulator::updateControls(uint16_t const result, std::unordered_set<ControlFlags> const& affected)
+Byte Emulator::psw() const {
+    Controls const& controls = status_.controls;
+    return controls.s << 7 | controls.z << 6 | controls.ac << 4 | controls.p << 2 | 0x02 | controls.c;
+}
+
+void Emulator::setPsw(Byte psw) {
+    status_.controls.c = psw & 0x01;
+    status_.controls.p = psw & 0x04;
+    status_.controls.ac = psw & 0x10;
+    status_.controls.z = psw & 0x40;
+    status_.controls.s = psw & 0x80;
+}
+
+void Emulator::updateControls(uint16_t const result, std::initializer_list<ControlFlags> affected)
 {
     for (auto const& a: affected)
     {
@@ -36,188 +138,196 @@ void Emulator::updateControls(uint16_t const result, std::unordered_set<ControlF
 }
 
 void Emulator::ana(Byte b) {
+    status_.controls.ac = ((status_.a | b) & 0x08) != 0;
     status_.a &= b;
     updateControls(status_.a, {PARITY, SIGN, ZERO});
     status_.controls.c = false;
-    ++status_.pc;
 }
 
 void Emulator::xra(Byte b) {
+    status_.controls.ac = false;
     status_.a ^= b;
     updateControls(status_.a, {PARITY, SIGN, ZERO});
     status_.controls.c = false;
-    ++status_.pc;
 }
 
 void Emulator::ora(Byte b) {
+    status_.controls.ac = false;
     status_.a |= b;
     updateControls(status_.a, {PARITY, SIGN, ZERO});
     status_.controls.c = false;
-    ++status_.pc;
 }
 
 void Emulator::cmp(Byte b) {
     uint16_t tmp = (uint16_t) status_.a - (uint16_t) b;
     updateControls(tmp, {CARRY, PARITY, SIGN, ZERO});
-    ++status_.pc;
+    status_.controls.ac = auxCarry(status_.a, ~b, true);
 }
 
 
 void Emulator::pop(Byte& high, Byte& low) {
     low = status_.memory[status_.sp];
-    high = status_.memory[status_.sp+1];
+    high = status_.memory[(uint16_t) (status_.sp + 1)];
     status_.sp += 2;
-    ++status_.pc;
 }
 
 void Emulator::push(Byte& high, Byte& low) {
-    status_.memory[status_.sp - 1] = high;
-    status_.memory[status_.sp - 2] = low;
+    status_.memory[(uint16_t) (status_.sp - 1)] = high;
+    status_.memory[(uint16_t) (status_.sp - 2)] = low;
     status_.sp -= 2;
-    ++status_.pc;
 }
 
 void Emulator::ret() {
-    status_.pc = ((uint16_t) status_.memory[status_.sp + 1] << 8) | ((uint16_t) status_.memory[status_.sp]);
+    status_.pc = ((uint16_t) status_.memory[(uint16_t) (status_.sp + 1)] << 8) | ((uint16_t) status_.memory[status_.sp]);
     status_.sp += 2;
 }
 
-void Emulator::jmp() {
-    status_.pc = ((uint16_t) status_.memory[status_.pc+2] << 8) | ((uint16_t) status_.memory[status_.pc+1]);
+void Emulator::jmp(uint16_t addr) {
+    status_.pc = addr;
 }
 
-void Emulator::call() {
-    status_.memory[status_.sp - 1] = (status_.pc >> 8);
-    status_.memory[status_.sp - 2] = (status_.pc & 0xff);
+void Emulator::call(uint16_t addr) {
+    status_.memory[(uint16_t) (status_.sp - 1)] = (status_.pc >> 8);
+    status_.memory[(uint16_t) (status_.sp - 2)] = (status_.pc & 0xff);
     status_.sp -= 2;
-    jmp();
+    jmp(addr);
+}
+
+void Emulator::retIf(bool condition) {
+    if (!condition) { return; }
+    status_.cycles += opcodes[0xc0].cyclesTaken - opcodes[0xc0].cycles;
+    ret();
 }
 
-void Emulator::loadi(Byte& rpHigh, Byte& rpLow) {
-    rpLow = status_.memory[status_.pc + 1];
-    rpHigh = status_.memory[status_.pc + 2];
-    status_.pc += 3;
+void Emulator::callIf(bool condition, uint16_t addr) {
+    if (!condition) { return; }
+    status_.cycles += opcodes[0xc4].cyclesTaken - opcodes[0xc4].cycles;
+    call(addr);
 }
 
-void Emulator::loadsp() {
-    Byte lo = status_.memory[status_.pc + 1];
-    Byte hi = status_.memory[status_.pc + 2];
-    status_.sp = ((uint16_t) hi << 8) | (lo);
-    status_.pc += 3;
+void Emulator::loadi(uint16_t& rp, uint16_t data) {
+    rp = data;
 }
 
-void Emulator::ldax(Byte const& rpHigh, Byte const& rpLow) {
-    uint16_t addr = ((uint16_t) rpHigh << 8) | ((uint16_t) rpLow);
-    status_.a = status_.memory[addr];
-    ++status_.pc;
+void Emulator::ldax(uint16_t rp) {
+    status_.a = status_.memory[rp];
 }
 
-void Emulator::stax(Byte const& rpHigh, Byte const& rpLow) {
-    uint16_t addr = (rpHigh << 8 | rpLow);
-    status_.memory[addr] = status_.a;
-    ++status_.pc;
+void Emulator::stax(uint16_t rp) {
+    status_.memory[rp] = status_.a;
 }
 
-void Emulator::inx(Byte& rpHigh, Byte& rpLow) {
-    uint16_t rp = ((uint16_t) rpHigh << 8) | (rpLow);
-    rp += 1;
-    rpHigh = (rp >> 8);
-    rpLow = rp & 0xff;
-    ++status_.pc;
+void Emulator::inx(uint16_t& rp) {
+    ++rp;
 }
 
-void Emulator::dcx(Byte& rpHigh, Byte& rpLow) {
-    uint16_t rp = ((uint16_t) rpHigh << 8) | ((uint16_t) rpLow);
-    rp -= 1;
-    rpHigh = (rp >> 8);
-    rpLow = rp & 0xff;
-    ++status_.pc;
+void Emulator::dcx(uint16_t& rp) {
+    --rp;
 }
 
 void Emulator::inr(Byte& regr) {
     uint16_t tmp = (uint16_t) regr + 1;
     updateControls(tmp, {SIGN, ZERO, PARITY});
+    status_.controls.ac = auxCarry(regr, 1, false);
     regr = (tmp & 0xff);
-    ++status_.pc;
 }
 
 void Emulator::dcr(Byte& regr) {
     uint16_t tmp = regr - 1;
     updateControls(tmp, {SIGN, ZERO, PARITY});
+    status_.controls.ac = auxCarry(regr, ~1, true);
     regr = (tmp & 0xff);
-//    std::cout << (int) (tmp & 0xff) << ' ';
-   if (status_.controls.z) {std::cout << "ZERO" << std::endl;}
-    ++status_.pc;
 }
 
-void Emulator::mvi(Byte& regr) {
-    regr = status_.memory[status_.pc + 1];
-    status_.pc += 2;
+void Emulator::mvi(Byte& regr, Byte data) {
+    regr = data;
 }
 
 void Emulator::mov(Byte& dest, Byte const& src) {
     dest = src;
-    ++status_.pc;
 }
 
 void Emulator::add(Byte& dest, Byte const& operand) {
+    bool const ac = auxCarry(dest, operand, false);
     uint16_t tmp = (uint16_t) dest + (uint16_t) operand;
     updateControls(tmp, {SIGN, ZERO, PARITY, CARRY});
+    status_.controls.ac = ac;
     dest = tmp & 0xff;
-    ++status_.pc;
 }
 
 void Emulator::adc(Byte& dest, Byte const& operand) {
+    bool const ac = auxCarry(dest, operand, status_.controls.c);
     uint16_t tmp = (uint16_t) dest + (uint16_t) operand + (uint16_t) status_.controls.c;
     updateControls(tmp, {SIGN, ZERO, PARITY, CARRY});
+    status_.controls.ac = ac;
     dest = tmp & 0xff;
-    ++status_.pc;
 }
 
 void Emulator::sub(Byte& dest, Byte const& operand) {
+    bool const ac = auxCarry(dest, ~operand, true);
     uint16_t tmp = (uint16_t) dest - (uint16_t) operand;
     updateControls(tmp, {SIGN, ZERO, PARITY, CARRY});
+    status_.controls.ac = ac;
     dest = tmp & 0xff;
-    ++status_.pc;
 }
 
 void Emulator::sbb(Byte& dest, Byte const& operand) {
+    bool const ac = auxCarry(dest, ~operand, !status_.controls.c);
     uint16_t tmp = (uint16_t) dest - (uint16_t) operand - (uint16_t) status_.controls.c;
     updateControls(tmp, {SIGN, ZERO, PARITY, CARRY});
+    status_.controls.ac = ac;
     dest = tmp & 0xff;
-    ++status_.pc;
 }
 
-void Emulator::dad(Byte const& rpHigh, Byte const& rpLow) {
-    uint32_t hl = ((uint16_t) status_.h << 8) | ((uint16_t) status_.l);
-    uint32_t rp = ((uint16_t) rpHigh << 8) | ((uint16_t) rpLow);
-    hl += rp;
-    status_.h = hl >> 8;
-    status_.l = hl & 0xff;
+void Emulator::dad(uint16_t rp) {
+    uint32_t const hl = uint32_t {status_.hl} + rp;
+    status_.hl = hl;
     status_.controls.c = hl > 0xffff;
-    ++status_.pc;
 }
 
 
-void Emulator::emulateOp() {
+StopReason Emulator::emulateOp() {
+    return step<false>(0);
+}
+
+template <bool Fuse>
+StopReason Emulator::step(uint64_t end) {
     auto& mem = status_.memory;
-    uint16_t& pc = status_.pc;
-    Byte op = mem[pc];
+    uint16_t const pc = status_.pc;
+    Byte const op = mem[pc];
+    OpInfo const& info = opcodes[op];
+
+    if constexpr (Fuse) {
+        if (superinstructions::starts[op]) {
+            uint16_t const next = pc + info.length;
+            Byte const second = mem[next];
+            if (superinstructions::fuses(op, second) && status_.cycles + info.cycles < end
+                    && superinstructions::run(*this, pc, op, next, second)) {
+                ++fusedDispatches_;
+                return StopReason::NONE;
+            }
+        }
+    }
+
+    Byte const data = mem[(uint16_t) (pc + 1)];
+    uint16_t const addr = ((uint16_t) mem[(uint16_t) (pc + 2)] << 8) | data;
+
+    status_.pc += info.length;
+    status_.cycles += info.cycles;
 
     switch (op) {
         case 0x00:
-            ++status_.pc;
             break;
         case 0x01: { // LXI_B
-            loadi(status_.b, status_.c);
+            loadi(status_.bc, addr);
             break;
         }
         case 0x02: { // STAX_B
-            stax(status_.b, status_.c);
+            stax(status_.bc);
             break;
         }
         case 0x03: { // INX_B
-            inx(status_.b, status_.c);
+            inx(status_.bc);
             break;
         }
         case 0x04: { // INR_B
@@ -229,7 +339,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x06: { // MVI_B
-            mvi(status_.b);
+            mvi(status_.b, data);
             break;
         }
         case 0x07: { // RLC
@@ -238,22 +348,21 @@ void Emulator::emulateOp() {
             tmp |= ((tmp & 0x100) != 0);
             updateControls(tmp, {CARRY});
             status_.a = (tmp & 0xff);
-            ++status_.pc;
             break;
         }
         case 0x08: {
             break;
         }
         case 0x09: { // DAD_B
-            dad(status_.b, status_.c);
+            dad(status_.bc);
             break;
         }
         case 0x0a: { // LDAX B
-            ldax(status_.b, status_.c);
+            ldax(status_.bc);
             break;
         }
         case 0x0b: { // DCX B
-            dcx(status_.b, status_.c);
+            dcx(status_.bc);
             break;
         }
         case 0x0c: { // INR_C
@@ -265,33 +374,31 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x0e: { // MVI_C
-            mvi(status_.c);
+            mvi(status_.c, data);
             break;
         }
         case 0x0f: { // RRC
             bool carry = status_.a & 0x1;
             status_.a >>= 1;
             if (carry) {
-                status_.controls.c = true;
                 status_.a |= 0x80;
             }
-            ++status_.pc;
+            status_.controls.c = carry;
             break;
         }
         case 0x10: { // NOP
-            ++status_.pc;
             break;
         }
         case 0x11: { // LXI_D
-            loadi(status_.d, status_.e);
+            loadi(status_.de, addr);
             break;
         }
         case 0x12: { // STAX_D
-            stax(status_.d, status_.e);
+            stax(status_.de);
             break;
         }
         case 0x13: { // INX_D
-            inx(status_.d, status_.e);
+            inx(status_.de);
             break;
         }
         case 0x14: { // INR_D
@@ -303,7 +410,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x16: { // MVI_D
-            mvi(status_.d);
+            mvi(status_.d, data);
             break;
         }
         case 0x17: { // RAL
@@ -312,23 +419,21 @@ void Emulator::emulateOp() {
             tmp |= (status_.controls.c);
             updateControls(tmp, {CARRY});
             status_.a = (tmp & 0xff);
-            ++status_.pc;
             break;
         }
         case 0x18: { // NOP
-            ++status_.pc;
             break;
         }
         case 0x19: { // DAD_D
-            dad(status_.d, status_.e);
+            dad(status_.de);
             break;
         }
         case 0x1a: { // LDAX_D
-            ldax(status_.d, status_.e);
+            ldax(status_.de);
             break;
         }
         case 0x1b: { // DCX_D
-            dcx(status_.d, status_.e);
+            dcx(status_.de);
             break;
         }
         case 0x1c: { // INR_E
@@ -340,7 +445,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x1e: { // MVI_E
-            mvi(status_.e);
+            mvi(status_.e, data);
             break;
         }
         case 0x1f: { // RAR
@@ -350,29 +455,23 @@ void Emulator::emulateOp() {
                 status_.a |= 0x80;
             }
             status_.controls.c = tmp;
-            ++status_.pc;
             break;
         }
         case 0x20: { // NOP
-            ++status_.pc;
             break;
         }
         case 0x21: { // LXI_H
-            loadi(status_.h, status_.l);
+            loadi(status_.hl, addr);
             break;
         }
         case 0x22: { // SHLD
-            uint16_t r = mem[pc + 1];
-            uint16_t l = mem[pc + 2];
-            uint16_t offset = l << 8 | r;
-            mem[offset] = status_.l;
-            mem[offset+1] = status_.h;
+            mem[addr] = status_.l;
+            mem[(uint16_t) (addr + 1)] = status_.h;
 
-            status_.pc += 3;
             break;
         }
         case 0x23: { // INX_H
-            inx(status_.h, status_.l);
+            inx(status_.hl);
             break;
         }
         case 0x24: { // INR_H
@@ -384,32 +483,30 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x26: { // MVI_H
-            mvi(status_.h);
+            mvi(status_.h, data);
             break;
         }
-        case 0x27: { // DAA unused
-            throw NotImplementedInstruction(0x27);
+        case 0x27: { // DAA
+            uint16_t const entry = daaTable[status_.controls.ac << 9 | status_.controls.c << 8 | status_.a];
+            status_.a = entry & 0xff;
+            setPsw(entry >> 8);
+            break;
         }
         case 0x28: { // NOP
-            ++status_.pc;
             break;
         }
         case 0x29: { // DAD_H
-            dad(status_.h, status_.l);
+            dad(status_.hl);
             break;
         }
         case 0x2a: { // LHLD
-            uint16_t r = mem[pc + 1];
-            uint16_t l = mem[pc + 2];
-            uint16_t offset = l << 8 | r;
-            status_.l = mem[offset];
-            status_.h = mem[offset+1];
+            status_.l = mem[addr];
+            status_.h = mem[(uint16_t) (addr + 1)];
 
-            status_.pc += 3;
             break;
         }
         case 0x2b: { // DCX_H
-            dcx(status_.h, status_.l);
+            dcx(status_.hl);
             break;
         }
         case 0x2c: { // INR_L
@@ -421,28 +518,22 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x2e: { // MVI_L
-            mvi(status_.l);
+            mvi(status_.l, data);
             break;
         }
         case 0x2f: { // CMA
             status_.a = ~status_.a;
-            ++status_.pc;
             break;
         }
         case 0x30: { // NOP
-            ++status_.pc;
             break;
         }
         case 0x31: { // LXI_SP
-            loadsp();
+            status_.sp = addr;
             break;
         }
         case 0x32: { // STA
-            Byte lo = mem[pc + 1];
-            Byte hi = mem[pc + 2];
-            uint16_t addr = (hi << 8) | (lo);
             mem[addr] = status_.a;
-            status_.pc += 3;
             break;
         }
         case 0x33: { // INX_SP
@@ -450,18 +541,18 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x34: { // INR_M
-            uint16_t offset =  (status_.h << 8) | (status_.l);
+            uint16_t offset = status_.hl;
             inr(mem[offset]);
             break;
         }
         case 0x35: { // DCR_M
-            uint16_t offset =  (status_.h << 8) | (status_.l);
+            uint16_t offset = status_.hl;
             dcr(mem[offset]);
             break;
         }
         case 0x36: { // MVI_M
-            uint16_t offset =  ((uint16_t) status_.h << 8) | (status_.l);
-            mvi(mem[offset]);
+            uint16_t offset = status_.hl;
+            mvi(mem[offset], data);
             break;
         }
         case 0x37: { // STC
@@ -469,19 +560,14 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x38: { // NOP
-            ++status_.pc;
             break;
         }
         case 0x39: { // DAD_SP
-            Byte low = status_.sp & 0xff;
-            Byte high = status_.sp >> 8;
-            dad(high, low);
+            dad(status_.sp);
             break;
         }
         case 0x3a: { // LDA
-            uint16_t offset = (mem[pc + 2] << 8) | (mem[pc + 1]);
-            status_.a = mem[offset];
-            status_.pc += 3;
+            status_.a = mem[addr];
             break;
         }
         case 0x3b: { // DCX_SP
@@ -497,12 +583,11 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x3e: { // MVI_A
-            mvi(status_.a);
+            mvi(status_.a, data);
             break;
         }
         case 0x3f: { // CMC
             status_.controls.c = !status_.controls.c;
-            ++status_.pc;
             break;
         }
         case 0x40: { // MOV_BB
@@ -530,7 +615,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x46: { // MOV_BM
-            mov(status_.b, mem[(status_.h << 8) | (status_.l)]);
+            mov(status_.b, mem[status_.hl]);
             break;
         }
         case 0x47: { // MOV_BA
@@ -562,7 +647,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x4e: { // MOV_CM
-            mov(status_.c, mem[(status_.h << 8) |  status_.l]);
+            mov(status_.c, mem[status_.hl]);
             break;
         }
         case 0x4f: { // MOV_CA
@@ -594,7 +679,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x56: { // MOV_DM
-            mov(status_.d, mem[(status_.h << 8) | status_.l]);
+            mov(status_.d, mem[status_.hl]);
             break;
         }
         case 0x57: { // MOV_DA
@@ -626,7 +711,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x5e: { // MOV_EM
-            mov(status_.e, mem[(status_.h << 8) | status_.l]);
+            mov(status_.e, mem[status_.hl]);
             break;
         }
         case 0x5f: { // MOV_EA
@@ -658,7 +743,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x66: { // MOV_HM
-            mov(status_.h, mem[(status_.h << 8) | status_.l]);
+            mov(status_.h, mem[status_.hl]);
             break;
         }
         case 0x67: { // MOV_HA
@@ -690,7 +775,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x6e: { // MOV_LM
-            mov(status_.l, mem[(status_.h << 8) | status_.l]);
+            mov(status_.l, mem[status_.hl]);
             break;
         }
         case 0x6f: { // MOV_LA
@@ -698,34 +783,35 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x70: { // MOV_MB
-            mov(mem[(status_.h << 8) | status_.l], status_.b);
+            mov(mem[status_.hl], status_.b);
             break;
         }
         case 0x71: { // MOV_MC
-            mov(mem[(status_.h << 8) | status_.l], status_.c);
+            mov(mem[status_.hl], status_.c);
             break;
         }
         case 0x72: { // MOV_MD
-            mov(mem[(status_.h << 8) | status_.l], status_.d);
+            mov(mem[status_.hl], status_.d);
             break;
         }
         case 0x73: { // MOV_ME
-            mov(mem[(status_.h << 8) | status_.l], status_.e);
+            mov(mem[status_.hl], status_.e);
             break;
         }
         case 0x74: { // MOV_MH
-            mov(mem[(status_.h << 8) | status_.l], status_.h);
+            mov(mem[status_.hl], status_.h);
             break;
         }
         case 0x75: { // MOV_ML
-            mov(mem[(status_.h << 8) | status_.l], status_.l);
+            mov(mem[status_.hl], status_.l);
             break;
         }
         case 0x76: { // HLT
-            throw NotImplementedInstruction(0x76);
+            stop_ = {StopReason::HALTED, pc, op};
+            return StopReason::HALTED;
         }
         case 0x77: { // MOV_MA
-            mov(mem[((uint16_t) status_.h << 8) | (status_.l)], status_.a);
+            mov(mem[status_.hl], status_.a);
             break;
         }
         case 0x78: { // MOV_AB
@@ -753,7 +839,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x7e: { // MOV_AM
-            mov(status_.a, mem[(status_.h << 8) | status_.a]);
+            mov(status_.a, mem[status_.hl]);
             break;
         }
         case 0x7f: { // MOV_AA
@@ -785,7 +871,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x86: { // ADD_M
-            add(status_.a, mem[(status_.h << 8) | (status_.l)]);
+            add(status_.a, mem[status_.hl]);
             break;
         }
         case 0x87: { // ADD_A
@@ -817,7 +903,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x8e: { // ADC_M
-            adc(status_.a, mem[(status_.h << 8) | (status_.l)]);
+            adc(status_.a, mem[status_.hl]);
             break;
         }
         case 0x8f: { // ADC_A
@@ -849,7 +935,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x96: { // SUB_M
-            sub(status_.a, mem[(status_.h << 8) | (status_.l)]);
+            sub(status_.a, mem[status_.hl]);
             break;
         }
         case 0x97: { // SUB_A
@@ -881,7 +967,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0x9e: { // SBB_M
-            sbb(status_.a, mem[(status_.h << 8) | (status_.l)]);
+            sbb(status_.a, mem[status_.hl]);
             break;
         }
         case 0x9f: { // SBB_A
@@ -913,7 +999,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0xa6: { // ANA_M
-            ana(mem[(status_.h << 8) | (status_.l)]);
+            ana(mem[status_.hl]);
             break;
         }
         case 0xa7: { // ANA_A
@@ -945,7 +1031,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0xae: { // XRA_M
-            xra(mem[(status_.h << 8) | (status_.l)]);
+            xra(mem[status_.hl]);
             break;
         }
         case 0xaf: { // XRA_A
@@ -977,7 +1063,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0xb6: { // ORA_M
-            ora(mem[(status_.h << 8) | (status_.l)]);
+            ora(mem[status_.hl]);
             break;
         }
         case 0xb7: { // ORA_A
@@ -1009,7 +1095,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0xbe: { // CMP_M
-            cmp(mem[(status_.h << 8) | (status_.l)]);
+            cmp(mem[status_.hl]);
             break;
         }
         case 0xbf: { // CMP_A
@@ -1017,8 +1103,7 @@ void Emulator::emulateOp() {
             break;
         }
         case 0xc0: { // RNZ
-            if (status_.controls.z) {++status_.pc; break;}
-            ret();
+            retIf(!status_.controls.z);
             break;
         }
         case 0xc1: { // POP_B
@@ -1026,17 +1111,15 @@ void Emulator::emulateOp() {
             break;
         }
         case 0xc2: { // JNZ
-            if (status_.controls.z) {status_.pc+=3; break;}
-            jmp();
+            if (!status_.controls.z) { jmp(addr); }
             break;
         }
         case 0xc3: { // JMP
-            jmp();
+            jmp(addr);
             break;
         }
         case 0xc4: { // CNZ
-            if (status_.controls.z) {status_.pc+=3; break;}
-            call();
+            callIf(!status_.controls.z, addr);
             break;
         }
         case 0xc5: { // PUSH_B
@@ -1044,18 +1127,14 @@ void Emulator::emulateOp() {
             break;
         }
         case 0xc6: { // ADI
-            uint16_t tmp = (uint16_t) status_.a + (uint16_t) mem[pc+1];
-            updateControls(tmp, {CARRY, PARITY, SIGN, ZERO});
-            status_.a = tmp & 0xff;
-            status_.pc += 2;
+            add(status_.a, data);
             break;
         }
         case 0xc7: { // RST_0
-            throw NotImplementedInstruction(0xc7);
+            return unimplemented(pc, op);
         }
         case 0xc8: { // RZ
-            if (!status_.controls.z) {++status_.pc; break;}
-            ret();
+            retIf(status_.controls.z);
             break;
         }
         case 0xc9: { // RET
@@ -1063,36 +1142,30 @@ void Emulator::emulateOp() {
             break;
         }
         case 0xca: { // JZ
-            if (!status_.controls.z) {status_.pc+=3; break;}
-            jmp();
+            if (status_.controls.z) { jmp(addr); }
             break;
         }
         case 0xcb: { // JMP
-            jmp();
+            jmp(addr);
             break;
         }
         case 0xcc: { // CZ
-            if (!status_.controls.z) {status_.pc+=3; break;}
-            call();
+            callIf(status_.controls.z, addr);
             break;
         }
         case 0xcd: { // CALL
-            call();
+            call(addr);
             break;
         }
         case 0xce: { // ACI
-            uint16_t tmp = (uint16_t) status_.a + (uint16_t) mem[pc+1] + status_.controls.c;
-            updateControls(tmp, {CARRY, PARITY, SIGN, ZERO});
-            status_.a = tmp & 0xff;
-            status_.pc += 2;
+            adc(status_.a, data);
             break;
         }
         case 0xcf: { // RST_1
-            throw NotImplementedInstruction(0xcf);
+            return unimplemented(pc, op);
         }
         case 0xd0: { // RNC
-            if (status_.controls.c) break;
-            ret();
+            retIf(!status_.controls.c);
             break;
         }
         case 0xd1: { // POP_D
@@ -1100,17 +1173,21 @@ void Emulator::emulateOp() {
             break;
         }
         case 0xd2: { // JNC
-            if (status_.controls.c) {status_.pc+=3; break;}
-            jmp();
+            if (!status_.controls.c) { jmp(addr); }
             break;
         }
         case 0xd3: { // OUT
-            ++status_.pc;
+            if (shifter_ && data == ShiftRegister::dataPort) {
+                shifter_->shiftIn(status_.a);
+            } else if (shifter_ && data == ShiftRegister::offsetPort) {
+                shifter_->setOffset(status_.a);
+            } else if (ports_) {
+                ports_->out(data, status_.a, status_.cycles);
+            }
             break;
         }
         case 0xd4: { // CNC
-            if (status_.controls.c) {status_.pc+=3; break;}
-            call();
+            callIf(!status_.controls.c, addr);
             break;
         }
         case 0xd5: { // PUSH_D
@@ -1118,18 +1195,14 @@ void Emulator::emulateOp() {
             break;
         }
         case 0xd6: { // SUI
-            uint16_t tmp = (uint16_t) status_.a - (uint16_t) mem[pc+1];
-            updateControls(tmp, {CARRY, PARITY, SIGN, ZERO});
-            status_.a = tmp & 0xff;
-            status_.pc += 2;
+            sub(status_.a, data);
             break;
         }
         case 0xd7: { // RST_2
-            throw NotImplementedInstruction(0xd7);
+            return unimplemented(pc, op);
         }
         case 0xd8: { // RC
-            if (!status_.controls.c) {++status_.pc; break;}
-            ret();
+            retIf(status_.controls.c);
             break;
         }
         case 0xd9: { // RET
@@ -1137,36 +1210,34 @@ void Emulator::emulateOp() {
             break;
         }
         case 0xda: { // JC
-            if (!status_.controls.c) {status_.pc+=3; break;}
-            jmp();
+            if (status_.controls.c) { jmp(addr); }
             break;
         }
         case 0xdb: { // IN
-            ++status_.pc;
+            if (shifter_ && data == ShiftRegister::resultPort) {
+                status_.a = shifter_->result();
+            } else if (ports_) {
+                status_.a = ports_->in(data, status_.cycles);
+            }
             break;
         }
         case 0xdc: { // CC
-            if (!status_.controls.c) {status_.pc+=3; break;}
-            call();
+            callIf(status_.controls.c, addr);
             break;
         }
         case 0xdd: { // CALL
-            call();
+            call(addr);
             break;
         }
         case 0xde: { // SBI
-            uint16_t tmp = (uint16_t) status_.a - (uint16_t) mem[pc+1] - status_.controls.c;
-            updateControls(tmp, {CARRY, PARITY, SIGN, ZERO});
-            status_.a = tmp & 0xff;
-            status_.pc += 2;
+            sbb(status_.a, data);
             break;
         }
         case 0xdf: { // RST_3
-            throw NotImplementedInstruction(0xdf);
+            return unimplemented(pc, op);
         }
         case 0xe0: { // RPO
-            if (status_.controls.p) {++status_.pc; break;}
-            ret();
+            retIf(!status_.controls.p);
             break;
         }
         case 0xe1: { // POP_H
@@ -1174,23 +1245,18 @@ void Emulator::emulateOp() {
             break;
         }
         case 0xe2: { // JPO
-            if (status_.controls.p) {status_.pc+=3; break;}
-            jmp();
+            if (!status_.controls.p) { jmp(addr); }
             break;
         }
         case 0xe3: { // XTHL
-            Byte tmp = status_.h;
-            status_.h = mem[status_.sp+1];
-            mem[status_.sp+1] = tmp;
-            tmp = status_.l;
-            status_.l = mem[status_.sp];
-            mem[status_.sp] = tmp;
-            ++status_.pc;
+            uint16_t const top = mem[status_.sp] | mem[(uint16_t) (status_.sp + 1)] << 8;
+            mem[status_.sp] = status_.l;
+            mem[(uint16_t) (status_.sp + 1)] = status_.h;
+            status_.hl = top;
             break;
         }
         case 0xe4: { // CPO
-            if (status_.controls.p) {status_.pc+=3; break;}
-            call();
+            callIf(!status_.controls.p, addr);
             break;
         }
         case 0xe5: { // PUSH_H
@@ -1198,140 +1264,111 @@ void Emulator::emulateOp() {
             break;
         }
         case 0xe6: { // ANI
-            ana(mem[status_.pc+1]);
-            ++status_.pc;
+            ana(data);
             break;
         }
         case 0xe7: { // RST_4
-            throw NotImplementedInstruction(0xe7);
+            return unimplemented(pc, op);
         }
         case 0xe8: { // RPE
-            if (!status_.controls.p) {++status_.pc; break;}
-            ret();
+            retIf(status_.controls.p);
             break;
         }
         case 0xe9: { // PCHL
-            status_.pc = ((uint16_t) status_.h << 8) | (status_.l);
+            status_.pc = status_.hl;
             break;
         }
         case 0xea: { // JPE
-            if (!status_.controls.p) {status_.pc+=3; break;}
-            jmp();
+            if (status_.controls.p) { jmp(addr); }
             break;
         }
         case 0xeb: { // XCHG
-            Byte tmp = status_.h;
-            status_.h = status_.d;
-            status_.d = tmp;
-            tmp = status_.l;
-            status_.l = status_.e;
-            status_.e = tmp;
-            ++status_.pc;
+            std::swap(status_.hl, status_.de);
             break;
         }
         case 0xec: { // CPE
-            if (!status_.controls.p) {status_.pc+=3; break;}
-            call();
+            callIf(status_.controls.p, addr);
             break;
         }
         case 0xed: { // CALL
-            call();
+            call(addr);
             break;
         }
         case 0xee: { // XRI
-            xra(mem[status_.pc+1]);
-            ++status_.pc;
+            xra(data);
             break;
         }
         case 0xef: { // RST_5
-            throw NotImplementedInstruction(0xef);
+            return unimplemented(pc, op);
         }
         case 0xf0: { // RP
-            if (status_.controls.s) {++status_.pc; break;}
-            ret();
+            retIf(!status_.controls.s);
             break;
         }
         case 0xf1: { // POP_PSW
-            Byte b = mem[status_.sp];
-            status_.controls.c = b & 0x01;
-            status_.controls.p = b & 0x04;
-            status_.controls.z = b & 0x40;
-            status_.controls.s = b & 0x80;
-            status_.a = mem[status_.sp+1];
+            setPsw(mem[status_.sp]);
+            status_.a = mem[(uint16_t) (status_.sp + 1)];
             status_.sp += 2;
-            ++status_.pc;
             break;
         }
         case 0xf2: { // JP
-            if (status_.controls.s) {status_.pc+=3; break;}
-            jmp();
+            if (!status_.controls.s) { jmp(addr); }
             break;
         }
         case 0xf3: { // DI
             status_.is_interrupt_enabled = false;
-            ++status_.pc;
             break;
         }
         case 0xf4: { // CP
-            if (status_.controls.s) {status_.pc+=3; break;}
-            call();
+            callIf(!status_.controls.s, addr);
             break;
         }
         case 0xf5: { // PUSH_PSW
-            mem[status_.sp-1] = status_.a;
-            Controls const& controls = status_.controls;
-            Byte psw = controls.s << 7 | controls.z << 6 | controls.p << 2 | 0x02 | controls.c;
-            mem[status_.sp-2] = psw;
+            mem[(uint16_t) (status_.sp - 1)] = status_.a;
+            mem[(uint16_t) (status_.sp - 2)] = psw();
             status_.sp -= 2;
-            ++status_.pc;
             break;
         }
         case 0xf6: { // ORI
-            ora(mem[status_.pc+1]);
-            ++status_.pc;
+            ora(data);
             break;
         }
         case 0xf7: { // RST_6
-            throw NotImplementedInstruction(0xf7);
+            return unimplemented(pc, op);
         }
         case 0xf8: { // RM
-            if (!status_.controls.s) {++status_.pc; break;}
-            ret();
+            retIf(status_.controls.s);
             break;
         }
         case 0xf9: { // SPHL
-            status_.sp = ((uint16_t) status_.h << 8) | (status_.l);
-            ++status_.pc;
+            status_.sp = status_.hl;
             break;
         }
         case 0xfa: { // JM
-            if (!status_.controls.s) {status_.pc+=3; break;}
-            jmp();
+            if (status_.controls.s) { jmp(addr); }
             break;
         }
         case 0xfb: { // EI
             status_.is_interrupt_enabled = true;
-            ++status_.pc;
             break;
         }
         case 0xfc: { // CM
-            if (!status_.controls.s) {status_.pc+=3; break;}
-            call();
+            callIf(status_.controls.s, addr);
             break;
         }
         case 0xfd: { // CALL
-            call();
+            call(addr);
             break;
         }
         case 0xfe: { // CPI
-            cmp(mem[status_.pc+1]);
-            ++status_.pc;
+            cmp(data);
             break;
         }
         case 0xff: { // RST_7
-            throw NotImplementedInstruction(0xff);
+            return unimplemented(pc, op);
         }
-        default:
-            throw NotImplementedInstruction(0x00);
     }
+    return StopReason::NONE;
 }
+
+template StopReason Emulator::step<true>(uint64_t end);
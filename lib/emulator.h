@@ -6,10 +6,17 @@
 #define CPU8080_EMULATOR_H
 
 #include <stdint.h>
+#include <functional>
+#include <initializer_list>
 #include <vector>
 #include <memory>
-#include <unordered_set>
+#include <string>
+#include <type_traits>
 
+#include "debugger.h"
+#include "idioms.h"
+#include "rom.h"
+#include "shiftregister.h"
 #include "types.h"
 
 class Controls {
@@ -18,36 +25,87 @@ public:
     bool z {false};
     bool p {false};
     bool c {false};
+    bool ac {false};    // Auxiliary carry out of bit 3, only read by DAA and PUSH PSW.
 };
 
-class Status {
+// A register pair as a native uint16_t with its two 8-bit halves laid over it, so both
+// status.bc and status.b name storage. Reading the half that was not last written relies on union
+// type punning, which GCC, Clang and MSVC all define.
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define CPU8080_REGISTER_PAIR(pair, high, low) union { uint16_t pair {0}; struct { Byte high; Byte low; }; }
+#else
+#define CPU8080_REGISTER_PAIR(pair, high, low) union { uint16_t pair {0}; struct { Byte low; Byte high; }; }
+#endif
+
+// Everything an op reads or writes, memory's data pointer included, in one cache line. Emulator
+// keeps it first, so its cold state (debugger, idioms, devices, counters) starts on the next line.
+class alignas(64) Status {
 public:
     Status(): memory(1<<16, 0) {};
-    Byte a {0};
-    Byte b {0};
-    Byte c {0};
-    Byte d {0};
-    Byte e {0};
-    Byte h {0};
-    Byte l {0};
-    uint16_t sp {0};
+    uint64_t cycles {0};
     uint16_t pc {0};
-    std::vector<Byte> memory;
-
+    uint16_t sp {0};
+    CPU8080_REGISTER_PAIR(bc, b, c);
+    CPU8080_REGISTER_PAIR(de, d, e);
+    CPU8080_REGISTER_PAIR(hl, h, l);
+    Byte a {0};
     Controls controls;
     bool is_interrupt_enabled {true};
+    std::vector<Byte> memory;
+};
+static_assert(sizeof(Status) == 64, "Status should fill exactly one cache line");
 
+// Run loop hooks that compile away; Profiler (profiler.h) is the counting implementation.
+struct NullProfiler {
+    void beforeOp(Status const&) {}
+    void afterOp(Status const&) {}
 };
 
-class NotImplementedInstruction : public std::exception {
-private:
-    uint8_t opcode_;
-    std::string msg_;
+// Why emulateOp or run returned control to the caller.
+enum class StopReason : uint8_t {
+    NONE,                   // The op executed normally.
+    CYCLE_BUDGET,           // run used up its cycles.
+    HALTED,                 // HLT executed; pc is past it.
+    UNIMPLEMENTED_OPCODE,   // Stopped before an opcode Emulator does not implement; nothing changed.
+    BREAKPOINT,             // run stopped before an op at a breakpoint.
+    WATCHPOINT,             // run stopped before an op accessing a watched address.
+    CONDITION,              // run stopped before an op because a debugger condition held.
+};
+
+char const* toString(StopReason reason);
+
+struct Stop {
+    StopReason reason {StopReason::NONE};
+    uint16_t pc {0};        // Address of the op that stopped execution.
+    Byte opcode {0};
+    uint16_t address {0};   // The watched address, for WATCHPOINT.
+    uint8_t watchKind {0};  // The WatchKind of the watchpoint hit, for WATCHPOINT.
+
+    std::string describe() const;
+};
+
+// What emulateOp does with an opcode it does not implement.
+enum class UnimplementedPolicy : uint8_t {
+    HALT,       // Stop with UNIMPLEMENTED_OPCODE.
+    NOP,        // Skip it like a NOP of its length and timing.
+    CALLBACK,   // Ask the handler: true continues with whatever state it left (pc is already past
+                // the op), false stops like HALT.
+};
+
+// The devices behind IN and OUT, passed the cycle count after the op. An Emulator without any
+// leaves A alone on IN and drops OUT.
+class Ports {
 public:
-    NotImplementedInstruction(uint8_t opcode);
-    const char * what() const noexcept override;
+    virtual ~Ports() = default;
+    virtual Byte in(Byte port, uint64_t cycles) = 0;
+    virtual void out(Byte port, Byte value, uint64_t cycles) = 0;
 };
 
+class Emulator;
+using UnimplementedHandler = std::function<bool(Emulator&, Stop const&)>;
+// Told of each interrupt as it is taken: the cycle count before taking it and the RST vector.
+using InterruptListener = std::function<void(uint64_t cycles, Byte vector)>;
+
 class Emulator {
 public:
     void ana(Byte b);
@@ -57,30 +115,131 @@ public:
     void pop(Byte& high, Byte& low);
     void push(Byte& high, Byte& low);
     void ret();
-    void jmp();
-    void call();
-    void loadi(Byte& rpHigh, Byte& rpLow);
-    void loadsp();
-    void ldax(Byte const& rpHigh, Byte const& rpLow);
-    void stax(Byte const& rpHigh, Byte const& rpLow);
-    void inx(Byte& rpHigh, Byte& rpLow);
-    void dcx(Byte& rpHigh, Byte& rpLow);
+    void jmp(uint16_t addr);
+    void call(uint16_t addr);
+    void retIf(bool condition);
+    void callIf(bool condition, uint16_t addr);
+    void loadi(uint16_t& rp, uint16_t data);
+    void ldax(uint16_t rp);
+    void stax(uint16_t rp);
+    void inx(uint16_t& rp);
+    void dcx(uint16_t& rp);
     void inr(Byte& regr);
     void dcr(Byte& regr);
-    void mvi(Byte& regr);
+    void mvi(Byte& regr, Byte data);
     void mov(Byte& dest, Byte const& src);
-    void dad(Byte const& rpHigh, Byte const& rpLow);
+    void dad(uint16_t rp);
     void add(Byte& dest, Byte const& operand);
     void adc(Byte& dest, Byte const& operand);
     void sub(Byte& dest, Byte const& operand);
     void sbb(Byte& dest, Byte const& operand);
-    void updateControls(uint16_t result, std::unordered_set<ControlFlags> const& affected);
+    Byte psw() const;
+    void setPsw(Byte psw);
+    void updateControls(uint16_t result, std::initializer_list<ControlFlags> affected);
     void emulate();
-    void emulateOp();
+    // Executes the op at pc. Returns NONE unless it halted or hit an unimplemented opcode, in
+    // which case lastStop() has the details. Never throws.
+    StopReason emulateOp();
+    // Executes ops until at least cycles more states have elapsed or an op stops, reporting each
+    // one to profiler. While debugger_ has anything set, every op is checked against it first,
+    // except one the debugger has just stopped run at: resuming from a breakpoint does not stop at
+    // it again, while a run split into slices still checks the op each slice starts with.
+    // Otherwise, without a profiler, the pairs in superinstructions.h run in one dispatch while
+    // fusion() is on and idioms_ runs the loops it knows natively while enabled.
+    template <typename Profiler = NullProfiler>
+    Stop run(uint64_t cycles, Profiler&& profiler = Profiler{}) {
+        if (debugger_.active()) { return runLoop<true, false, false>(cycles, profiler); }
+        if constexpr (std::is_same_v<std::remove_cvref_t<Profiler>, NullProfiler>) {
+            if (idioms_.enabled()) {
+                return fusion_ ? runLoop<false, true, true>(cycles, profiler) : runLoop<false, true, false>(cycles, profiler);
+            }
+            if (fusion_) { return runLoop<false, false, true>(cycles, profiler); }
+        }
+        return runLoop<false, false, false>(cycles, profiler);
+    }
+    Stop const& lastStop() const { return stop_; }
+    // Services an interrupt whose device supplies RST vector: pushes pc, jumps to vector * 8 and
+    // disables interrupts. False, changing nothing, while interrupts are disabled.
+    bool interrupt(Byte vector);
+    // One listener at a time; a Timeline sets itself so that seeking replays the interrupts.
+    void setInterruptListener(InterruptListener listener) { interruptListener_ = std::move(listener); }
+    void setPorts(Ports* ports) { ports_ = ports; }
+    Ports* ports() const { return ports_; }
+    // Takes over the shift register's three ports from ports().
+    void setShiftRegister(ShiftRegister* shifter) { shifter_ = shifter; }
+    ShiftRegister* shiftRegister() const { return shifter_; }
+    // Superinstructions in run; emulateOp always runs a single op. Off by default: on this switch
+    // interpreter the pair check costs about as much as the dispatches it saves (see BM_Fusion).
+    void setFusion(bool fusion) { fusion_ = fusion; }
+    bool fusion() const { return fusion_; }
+    // Pairs run as one dispatch so far: each saves a dispatch over running the ops one by one.
+    uint64_t fusedDispatches() const { return fusedDispatches_; }
+    // Ops run so far through run, counting both ops of a fused pair and every op of the loops
+    // idioms_ ran; emulateOp on its own does not count.
+    uint64_t ops() const { return dispatches_ + fusedDispatches_ + idioms_.ops(); }
+    // Unimplemented opcodes met so far, whatever the policy did with them.
+    uint64_t unimplementedHits() const { return unimplementedHits_; }
+    void setUnimplementedPolicy(UnimplementedPolicy policy, UnimplementedHandler handler = {});
 
     void setMemory(std::string const& filename);
+    void setMemory(std::vector<RomPart> const& parts);
 
     Status status_;
+    Debugger debugger_;
+    Idioms idioms_;
+
+private:
+    template <bool Debug, bool Recognize, bool Fuse, typename Profiler>
+    Stop runLoop(uint64_t cycles, Profiler& profiler) {
+        uint64_t const end = status_.cycles + cycles;
+        uint64_t dispatches = 0;    // Kept local and added up once, off the loop.
+        bool resuming = status_.pc == debuggerStopPc_ && status_.cycles == debuggerStopCycles_;
+        while (status_.cycles < end) {
+            if constexpr (Debug) {
+                if (!resuming && (debugger_.breakpointAt(status_.pc) || debugger_.slowChecks())
+                        && debugger_.check(status_, stop_)) {
+                    debuggerStopPc_ = status_.pc;
+                    debuggerStopCycles_ = status_.cycles;
+                    dispatches_ += dispatches;
+                    return stop_;
+                }
+                resuming = false;
+            }
+            profiler.beforeOp(status_);
+            uint16_t const pc = status_.pc;
+            StopReason const reason = Fuse ? step<true>(end) : emulateOp();
+            if (reason != StopReason::NONE) [[unlikely]] {
+                // A stopped op did not run, unless it halted; an unimplemented one was rewound.
+                if (reason == StopReason::HALTED) { profiler.afterOp(status_); }
+                dispatches_ += dispatches + (reason == StopReason::HALTED);
+                return stop_;
+            }
+            profiler.afterOp(status_);
+            ++dispatches;
+            if constexpr (Recognize) {
+                if (status_.pc < pc && status_.cycles < end) { idioms_.run(*this, end - status_.cycles); }
+            }
+        }
+        dispatches_ += dispatches;
+        return {StopReason::CYCLE_BUDGET, status_.pc, status_.memory[status_.pc]};
+    }
+    // emulateOp, or with Fuse a superinstruction when its second op would still start before end.
+    template <bool Fuse>
+    StopReason step(uint64_t end);
+    StopReason unimplemented(uint16_t pc, Byte op);
+
+    Stop stop_;
+    Ports* ports_ {nullptr};
+    ShiftRegister* shifter_ {nullptr};
+    UnimplementedPolicy unimplementedPolicy_ {UnimplementedPolicy::HALT};
+    UnimplementedHandler unimplementedHandler_;
+    InterruptListener interruptListener_;
+    uint64_t debuggerStopCycles_ {UINT64_MAX};  // Where the debugger last stopped run, to resume past.
+    uint16_t debuggerStopPc_ {0};
+    uint64_t fusedDispatches_ {0};
+    uint64_t dispatches_ {0};
+    uint64_t unimplementedHits_ {0};
+    bool fusion_ {false};
 };
 
 #endif //CPU8080_EMULATOR_H
@@ -0,0 +1,181 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "flowgraph.h"
+
+#include <algorithm>
+
+#include "disassembler.h"
+#include "rom.h"
+
+namespace {
+
+constexpr uint8_t INSTRUCTION = 1 << 0;
+constexpr uint8_t LEADER = 1 << 1;
+
+bool fallsThrough(FlowKind flow) {
+    return flow != FLOW_JUMP && flow != FLOW_RET && flow != FLOW_INDIRECT && flow != FLOW_HALT;
+}
+
+bool hasTarget(FlowKind flow) {
+    return flow == FLOW_JUMP || flow == FLOW_COND_JUMP || flow == FLOW_CALL || flow == FLOW_COND_CALL || flow == FLOW_RST;
+}
+
+uint16_t targetOf(std::span<Byte const> image, uint32_t pc) {
+    Byte const op = image[pc];
+    if (opcodes[op].flow == FLOW_RST) { return op & 0x38; }
+    return (uint16_t) image[pc + 2] << 8 | image[pc + 1];
+}
+
+void appendHex(std::string& out, uint16_t value) {
+    constexpr char digits[] = "0123456789abcdef";
+    for (int shift = 12; shift >= 0; shift -= 4) { out += digits[(value >> shift) & 0xf]; }
+}
+
+}
+
+std::vector<uint16_t> FlowGraph::defaultEntries() {
+    std::vector<uint16_t> entries;
+    for (uint16_t vector = 0; vector < 0x40; vector += 8) { entries.push_back(vector); }
+    return entries;
+}
+
+FlowGraph FlowGraph::analyze(std::span<Byte const> image, std::vector<uint16_t> const& entries) {
+    FlowGraph graph;
+    graph.entries_ = entries;
+
+    std::vector<uint8_t> marks(addressSpaceSize + 1, 0);
+    auto decodable = [&](uint32_t pc) {
+        return pc < image.size() && pc + opcodes[image[pc]].length <= image.size();
+    };
+
+    std::vector<uint16_t> work;
+    for (auto entry: entries) {
+        marks[entry] |= LEADER;
+        work.push_back(entry);
+    }
+
+    while (!work.empty()) {
+        uint32_t pc = work.back();
+        work.pop_back();
+        while (decodable(pc) && !(marks[pc] & INSTRUCTION)) {
+            marks[pc] |= INSTRUCTION;
+            ++graph.instructions_;
+            OpInfo const& info = opcodes[image[pc]];
+            uint32_t const next = pc + info.length;
+            if (info.flow == FLOW_NONE) {
+                pc = next;
+                continue;
+            }
+            if (hasTarget(info.flow)) {
+                uint16_t const target = targetOf(image, pc);
+                marks[target] |= LEADER;
+                work.push_back(target);
+            }
+            if (!fallsThrough(info.flow)) { break; }
+            marks[next] |= LEADER;
+            pc = next;
+        }
+    }
+
+    for (uint32_t start = 0; start < image.size(); ++start) {
+        if ((marks[start] & (LEADER | INSTRUCTION)) != (LEADER | INSTRUCTION)) { continue; }
+
+        BasicBlock block;
+        block.start = start;
+        uint32_t pc = start;
+        while (true) {
+            OpInfo const& info = opcodes[image[pc]];
+            uint32_t const next = pc + info.length;
+            block.last = pc;
+            block.end = next;
+            if (info.flow != FLOW_NONE) {
+                block.exit = info.flow;
+                if (hasTarget(info.flow)) {
+                    bool const isCall = info.flow == FLOW_CALL || info.flow == FLOW_COND_CALL || info.flow == FLOW_RST;
+                    block.successors.push_back({targetOf(image, pc), isCall ? EDGE_CALL : EDGE_JUMP});
+                }
+                if (fallsThrough(info.flow)) { block.successors.push_back({(uint16_t) next, EDGE_FALLTHROUGH}); }
+                break;
+            }
+            if (!(marks[next] & INSTRUCTION) || (marks[next] & LEADER)) {
+                block.successors.push_back({(uint16_t) next, EDGE_FALLTHROUGH});
+                break;
+            }
+            pc = next;
+        }
+        graph.blocks_.emplace(block.start, std::move(block));
+    }
+
+    return graph;
+}
+
+BasicBlock const* FlowGraph::blockAt(uint16_t start) const {
+    auto it = blocks_.find(start);
+    return it == blocks_.end() ? nullptr : &it->second;
+}
+
+std::string FlowGraph::toText(std::span<Byte const> image) const {
+    Disassembler disassembler;
+    std::string out;
+    char line[Disassembler::maxLineLength];
+
+    for (auto const& [start, block]: blocks_) {
+        out += "block $";
+        appendHex(out, start);
+        out += "..$";
+        appendHex(out, block.last);
+        if (std::find(entries_.begin(), entries_.end(), start) != entries_.end()) { out += " entry"; }
+        out += '\n';
+
+        for (uint32_t pc = start; pc < block.end;) {
+            char* cursor = line;
+            pc += disassembler.disassembleOp(pc, image, cursor);
+            out.append(line, cursor);
+        }
+
+        char const* separator = "  ->";
+        for (auto const& edge: block.successors) {
+            out += separator;
+            out += " $";
+            appendHex(out, edge.target);
+            out += edge.kind == EDGE_CALL ? " call" : (edge.kind == EDGE_JUMP ? " jump" : " fallthrough");
+            separator = ",";
+        }
+        out += "\n\n";
+    }
+    return out;
+}
+
+std::string FlowGraph::toDot(std::span<Byte const> image) const {
+    Disassembler disassembler;
+    std::string out = "digraph flow {\n    node [shape=box fontname=\"monospace\"];\n";
+    char line[Disassembler::maxLineLength];
+
+    for (auto const& [start, block]: blocks_) {
+        out += "    b";
+        appendHex(out, start);
+        out += " [label=\"";
+        for (uint32_t pc = start; pc < block.end;) {
+            char* cursor = line;
+            pc += disassembler.disassembleOp(pc, image, cursor);
+            for (char const* c = line; c != cursor; ++c) {
+                if (*c == '\t') { out += ' '; }
+                else if (*c == '\n') { out += "\\l"; }
+                else { out += *c; }
+            }
+        }
+        out += "\"];\n";
+
+        for (auto const& edge: block.successors) {
+            out += "    b";
+            appendHex(out, start);
+            out += " -> b";
+            appendHex(out, edge.target);
+            out += edge.kind == EDGE_CALL ? " [style=dashed];\n" : ";\n";
+        }
+    }
+    out += "}\n";
+    return out;
+}
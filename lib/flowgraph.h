@@ -0,0 +1,56 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_FLOWGRAPH_H
+#define CPU8080_FLOWGRAPH_H
+
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "opcodes.h"
+#include "types.h"
+
+enum EdgeKind : uint8_t { EDGE_FALLTHROUGH, EDGE_JUMP, EDGE_CALL };
+
+struct Edge {
+    uint16_t target;
+    EdgeKind kind;
+};
+
+// Straight-line run of instructions entered only at start and left only after its last op.
+struct BasicBlock {
+    uint16_t start {0};
+    uint16_t last {0};       // Address of the final instruction.
+    uint32_t end {0};        // One past the final instruction.
+    FlowKind exit {FLOW_NONE};
+    std::vector<Edge> successors;
+};
+
+class FlowGraph {
+public:
+    // The reset vector and the eight RST vectors.
+    static std::vector<uint16_t> defaultEntries();
+
+    // Follows jumps, calls and returns from entries through image. Targets outside of image (RAM) are
+    // kept as edges but not decoded.
+    static FlowGraph analyze(std::span<Byte const> image, std::vector<uint16_t> const& entries = defaultEntries());
+
+    BasicBlock const* blockAt(uint16_t start) const;
+    std::map<uint16_t, BasicBlock> const& blocks() const { return blocks_; }
+    size_t instructionCount() const { return instructions_; }
+
+    // Listing of every block with its disassembly and successors.
+    std::string toText(std::span<Byte const> image) const;
+    // Graphviz digraph with one node per block; call edges are dashed.
+    std::string toDot(std::span<Byte const> image) const;
+
+private:
+    std::map<uint16_t, BasicBlock> blocks_;
+    std::vector<uint16_t> entries_;
+    size_t instructions_ {0};
+};
+
+#endif //CPU8080_FLOWGRAPH_H
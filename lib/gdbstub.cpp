@@ -0,0 +1,432 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gdbstub.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+char const hexDigits[] = "0123456789abcdef";
+// Queued once the client is gone. A payload ends at '#', so no packet reads as this one.
+char const disconnected[] = "#";
+
+void appendHex(std::string& out, Byte value) {
+    out += hexDigits[value >> 4];
+    out += hexDigits[value & 0x0f];
+}
+
+void appendWord(std::string& out, uint16_t value) {
+    appendHex(out, value & 0xff);
+    appendHex(out, value >> 8);
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') { return c - '0'; }
+    if (c >= 'a' && c <= 'f') { return c - 'a' + 10; }
+    if (c >= 'A' && c <= 'F') { return c - 'A' + 10; }
+    return -1;
+}
+
+// Parses the hex number at text[pos], advancing pos past it.
+uint32_t parseHex(std::string const& text, size_t& pos) {
+    uint32_t value = 0;
+    while (pos < text.size() && hexValue(text[pos]) >= 0) { value = value << 4 | hexValue(text[pos++]); }
+    return value;
+}
+
+Byte parseByte(std::string const& text, size_t pos) {
+    return hexValue(text[pos]) << 4 | hexValue(text[pos + 1]);
+}
+
+uint16_t parseWord(std::string const& text, size_t pos) {
+    return parseByte(text, pos) | parseByte(text, pos + 2) << 8;
+}
+
+[[noreturn]] void fail(std::string const& what) {
+    throw GdbStubError(what + ": " + std::strerror(errno));
+}
+
+// The register pairs in the order of the g packet.
+uint16_t readRegister(Emulator const& emulator, int index) {
+    Status const& s = emulator.status_;
+    switch (index) {
+        case 0: return s.a << 8 | emulator.psw();
+        case 1: return s.bc;
+        case 2: return s.de;
+        case 3: return s.hl;
+        case 4: return s.sp;
+        default: return s.pc;
+    }
+}
+
+void writeRegister(Emulator& emulator, int index, uint16_t value) {
+    Status& s = emulator.status_;
+    Byte const high = value >> 8;
+    Byte const low = value & 0xff;
+    switch (index) {
+        case 0: s.a = high; emulator.setPsw(low); break;
+        case 1: s.bc = value; break;
+        case 2: s.de = value; break;
+        case 3: s.hl = value; break;
+        case 4: s.sp = value; break;
+        default: s.pc = value; break;
+    }
+}
+
+constexpr int registerCount = 6;
+
+}
+
+GdbStub::GdbStub(uint16_t port) {
+    listenFd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd_ < 0) { fail("gdb stub socket"); }
+    int const reuse = 1;
+    setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof reuse);
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    socklen_t length = sizeof address;
+    if (bind(listenFd_, reinterpret_cast<sockaddr*>(&address), length) < 0
+            || getsockname(listenFd_, reinterpret_cast<sockaddr*>(&address), &length) < 0) {
+        close(listenFd_);
+        fail("gdb stub bind to port " + std::to_string(port));
+    }
+    port_ = ntohs(address.sin_port);
+    start();
+}
+
+GdbStub::GdbStub(std::string const& unixPath): unixPath_(unixPath) {
+    sockaddr_un address {};
+    if (unixPath.size() >= sizeof address.sun_path) { throw GdbStubError("gdb stub socket path too long: " + unixPath); }
+    listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd_ < 0) { fail("gdb stub socket"); }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, unixPath.c_str(), unixPath.size() + 1);
+    unlink(unixPath.c_str());
+    if (bind(listenFd_, reinterpret_cast<sockaddr*>(&address), sizeof address) < 0) {
+        close(listenFd_);
+        fail("gdb stub bind to " + unixPath);
+    }
+    start();
+}
+
+void GdbStub::start() {
+    if (listen(listenFd_, 1) < 0) {
+        close(listenFd_);
+        fail("gdb stub listen");
+    }
+    reader_ = std::thread(&GdbStub::readLoop, this);
+}
+
+GdbStub::~GdbStub() {
+    stopping_ = true;
+    shutdown(listenFd_, SHUT_RDWR);
+    if (int const client = clientFd_.load(); client >= 0) { shutdown(client, SHUT_RDWR); }
+    reader_.join();
+    close(listenFd_);
+    if (!unixPath_.empty()) { unlink(unixPath_.c_str()); }
+}
+
+void GdbStub::readLoop() {
+    while (!stopping_) {
+        int const client = accept(listenFd_, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR) { continue; }
+            break;
+        }
+        clientFd_ = client;
+        noAck_ = false;
+        receive(client);
+        clientFd_ = -1;
+        close(client);
+        push(disconnected);
+    }
+}
+
+// Splits the stream into $payload#checksum packets, acknowledging each, and passes a bare ^C on
+// as an interrupt.
+void GdbStub::receive(int clientFd) {
+    enum { IDLE, PAYLOAD, CHECKSUM_HIGH, CHECKSUM_LOW } state = IDLE;
+    std::string payload;
+    Byte sum = 0;
+    int checksum = 0;
+    char buffer[4096];
+    while (!stopping_) {
+        ssize_t const count = recv(clientFd, buffer, sizeof buffer, 0);
+        if (count <= 0) {
+            if (count < 0 && errno == EINTR) { continue; }
+            return;
+        }
+        for (ssize_t i = 0; i < count; ++i) {
+            char const c = buffer[i];
+            switch (state) {
+                case IDLE:
+                    if (c == '$') {
+                        payload.clear();
+                        sum = 0;
+                        state = PAYLOAD;
+                    } else if (c == '\x03') {
+                        push("\x03");
+                    }
+                    break;
+                case PAYLOAD:
+                    if (c == '#') {
+                        state = CHECKSUM_HIGH;
+                    } else {
+                        payload += c;
+                        sum += c;
+                    }
+                    break;
+                case CHECKSUM_HIGH:
+                    checksum = hexValue(c) << 4;
+                    state = CHECKSUM_LOW;
+                    break;
+                case CHECKSUM_LOW:
+                    checksum |= hexValue(c);
+                    state = IDLE;
+                    if (checksum != sum) {
+                        if (!noAck_) { sendRaw("-"); }
+                        break;
+                    }
+                    if (!noAck_) { sendRaw("+"); }
+                    if (payload == "QStartNoAckMode") {
+                        // Acknowledged above; everything after the OK goes unacknowledged.
+                        send("OK");
+                        noAck_ = true;
+                        break;
+                    }
+                    push(payload);
+                    break;
+            }
+        }
+    }
+}
+
+void GdbStub::push(std::string packet) {
+    {
+        std::lock_guard lock(queueMutex_);
+        queue_.push_back(std::move(packet));
+        pending_.store(true, std::memory_order_relaxed);
+    }
+    queueReady_.notify_one();
+}
+
+bool GdbStub::nextPacket(std::string& packet, bool wait) {
+    std::unique_lock lock(queueMutex_);
+    if (wait) {
+        queueReady_.wait(lock, [&] { return !queue_.empty(); });
+    } else if (queue_.empty()) {
+        return true;
+    }
+    packet = std::move(queue_.front());
+    queue_.pop_front();
+    pending_.store(!queue_.empty(), std::memory_order_relaxed);
+    return packet != disconnected;
+}
+
+void GdbStub::sendRaw(std::string const& bytes) {
+    int const client = clientFd_.load();
+    if (client < 0) { return; }
+    std::lock_guard lock(sendMutex_);
+    for (size_t sent = 0; sent < bytes.size();) {
+        ssize_t const count = ::send(client, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL);
+        if (count <= 0) {
+            if (count < 0 && errno == EINTR) { continue; }
+            return;
+        }
+        sent += count;
+    }
+}
+
+void GdbStub::send(std::string const& payload) {
+    Byte sum = 0;
+    for (char c: payload) { sum += c; }
+    std::string packet = "$" + payload + "#";
+    appendHex(packet, sum);
+    sendRaw(packet);
+}
+
+void GdbStub::sendStop(Stop const& stop) {
+    switch (stop.reason) {
+        case StopReason::WATCHPOINT: {
+            char const* const kind = stop.watchKind == WATCH_WRITE ? "watch" : stop.watchKind == WATCH_READ ? "rwatch" : "awatch";
+            char reply[32];
+            std::snprintf(reply, sizeof reply, "T05%s:%04x;", kind, stop.address);
+            send(reply);
+            break;
+        }
+        case StopReason::UNIMPLEMENTED_OPCODE:
+            send("S04");    // SIGILL
+            break;
+        default:
+            send("S05");    // SIGTRAP
+            break;
+    }
+}
+
+GdbStub::Action GdbStub::handle(Emulator& emulator, std::string const& packet) {
+    Status& status = emulator.status_;
+    Debugger& debugger = emulator.debugger_;
+    size_t pos = 1;
+    switch (packet[0]) {
+        case '?':
+            send("S05");
+            return Action::STAY;
+        case 'g': {
+            std::string reply;
+            for (int r = 0; r < registerCount; ++r) { appendWord(reply, readRegister(emulator, r)); }
+            send(reply);
+            return Action::STAY;
+        }
+        case 'G': {
+            for (size_t r = 0; r < registerCount && 1 + 4 * (r + 1) <= packet.size(); ++r) {
+                writeRegister(emulator, r, parseWord(packet, 1 + 4 * r));
+            }
+            send("OK");
+            return Action::STAY;
+        }
+        case 'p': {
+            uint32_t const r = parseHex(packet, pos);
+            std::string reply;
+            if (r < registerCount) { appendWord(reply, readRegister(emulator, r)); } else { reply = "E01"; }
+            send(reply);
+            return Action::STAY;
+        }
+        case 'P': {
+            uint32_t const r = parseHex(packet, pos);
+            if (r >= registerCount || pos + 5 > packet.size()) {
+                send("E01");
+                return Action::STAY;
+            }
+            writeRegister(emulator, r, parseWord(packet, pos + 1));
+            send("OK");
+            return Action::STAY;
+        }
+        case 'm': {
+            uint16_t address = parseHex(packet, pos);
+            ++pos;
+            uint32_t const length = parseHex(packet, pos);
+            std::string reply;
+            for (uint32_t i = 0; i < length && i < 0x10000; ++i) { appendHex(reply, status.memory[address++]); }
+            send(reply);
+            return Action::STAY;
+        }
+        case 'M': {
+            uint16_t address = parseHex(packet, pos);
+            ++pos;
+            uint32_t const length = parseHex(packet, pos);
+            ++pos;
+            if (pos + 2 * length > packet.size()) {
+                send("E01");
+                return Action::STAY;
+            }
+            for (uint32_t i = 0; i < length; ++i) { status.memory[address++] = parseByte(packet, pos + 2 * i); }
+            send("OK");
+            return Action::STAY;
+        }
+        case 'Z':
+        case 'z': {
+            uint32_t const type = parseHex(packet, pos);
+            ++pos;
+            uint16_t const address = parseHex(packet, pos);
+            ++pos;
+            uint16_t const length = std::max<uint32_t>(1, parseHex(packet, pos));
+            bool const insert = packet[0] == 'Z';
+            static uint8_t const kinds[] = {0, 0, WATCH_WRITE, WATCH_READ, WATCH_ACCESS};
+            if (type > 4) {
+                send("");
+            } else if (type <= 1) {
+                if (insert) { debugger.addBreakpoint(address); } else { debugger.removeBreakpoint(address); }
+                send("OK");
+            } else {
+                if (insert) {
+                    debugger.addWatchpoint(address, length, kinds[type]);
+                } else {
+                    debugger.removeWatchpoint(address, length, kinds[type]);
+                }
+                send("OK");
+            }
+            return Action::STAY;
+        }
+        case 's': {
+            if (pos < packet.size()) { status.pc = parseHex(packet, pos); }
+            Stop stop {StopReason::NONE, status.pc};
+            if (emulator.emulateOp() != StopReason::NONE) { stop = emulator.lastStop(); }
+            sendStop(stop);
+            return Action::STAY;
+        }
+        case 'c':
+            if (pos < packet.size()) { status.pc = parseHex(packet, pos); }
+            return Action::RESUME;
+        case 'D':
+            send("OK");
+            return Action::END;
+        case 'k':
+            return Action::END;
+        case 'H':
+            send("OK");
+            return Action::STAY;
+        case 'q':
+            if (packet.rfind("qSupported", 0) == 0) {
+                send("PacketSize=4000;QStartNoAckMode+;swbreak+;hwbreak+");
+            } else if (packet == "qAttached") {
+                send("1");
+            } else if (packet == "qC") {
+                send("QC1");
+            } else if (packet == "qfThreadInfo") {
+                send("m1");
+            } else if (packet == "qsThreadInfo") {
+                send("l");
+            } else {
+                send("");
+            }
+            return Action::STAY;
+        default:
+            send("");
+            return Action::STAY;
+    }
+}
+
+void GdbStub::serve(Emulator& emulator, uint64_t sliceCycles) {
+    bool running = false;
+    std::string packet;
+    while (true) {
+        if (!running) {
+            if (!nextPacket(packet, true)) { return; }
+            if (packet == "\x03") {
+                send("S02");    // SIGINT
+                continue;
+            }
+            Action const action = handle(emulator, packet);
+            if (action == Action::END) { return; }
+            running = action == Action::RESUME;
+            continue;
+        }
+
+        Stop const stop = emulator.run(sliceCycles);
+        if (stop.reason != StopReason::CYCLE_BUDGET) {
+            sendStop(stop);
+            running = false;
+        }
+        while (pending()) {
+            if (!nextPacket(packet, false)) { return; }
+            if (packet == "\x03") {
+                if (running) { send("S02"); }
+                running = false;
+            } else if (handle(emulator, packet) == Action::END) {
+                return;
+            }
+        }
+    }
+}
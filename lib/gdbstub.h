@@ -0,0 +1,76 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_GDBSTUB_H
+#define CPU8080_GDBSTUB_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "emulator.h"
+
+class GdbStubError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// GDB remote serial protocol server for one Emulator. A background thread accepts one client at a
+// time and splits its byte stream into packets; serve() runs the emulator on the calling thread in
+// slices and only looks at the packet queue between slices once the thread has flagged a packet,
+// so an attached but idle debugger costs one relaxed atomic load per slice.
+//
+// Registers are exchanged as the 16-bit pairs AF, BC, DE, HL, SP, PC (little-endian hex, F being
+// the PSW flag byte), the first six registers of GDB's z80 layout.
+class GdbStub {
+public:
+    // Listens on 127.0.0.1:port; 0 picks a free port, see port(). Throws GdbStubError.
+    explicit GdbStub(uint16_t port);
+    // Listens on a Unix domain socket at path, replacing any stale socket file. Throws GdbStubError.
+    explicit GdbStub(std::string const& unixPath);
+    GdbStub(GdbStub const&) = delete;
+    GdbStub& operator=(GdbStub const&) = delete;
+    ~GdbStub();
+
+    uint16_t port() const { return port_; }
+    bool pending() const { return pending_.load(std::memory_order_relaxed); }
+
+    // Waits for a client and runs emulator under its control, sliceCycles at a time while it is
+    // continuing, until the client detaches, kills the session or disconnects.
+    void serve(Emulator& emulator, uint64_t sliceCycles = 20000);
+
+private:
+    enum class Action { STAY, RESUME, END };
+
+    void start();
+    void readLoop();
+    void receive(int clientFd);
+    void push(std::string packet);
+    // Takes the next packet, waiting for one when wait is set. False once the client is gone.
+    bool nextPacket(std::string& packet, bool wait);
+    void send(std::string const& payload);
+    void sendRaw(std::string const& bytes);
+    void sendStop(Stop const& stop);
+    Action handle(Emulator& emulator, std::string const& packet);
+
+    int listenFd_ {-1};
+    uint16_t port_ {0};
+    std::string unixPath_;
+    std::atomic<int> clientFd_ {-1};
+    std::atomic<bool> pending_ {false};
+    std::atomic<bool> stopping_ {false};
+    bool noAck_ {false};
+
+    std::mutex queueMutex_;
+    std::condition_variable queueReady_;
+    std::deque<std::string> queue_;     // Packet payloads; "\x03" is an interrupt, "#" a disconnect.
+    std::mutex sendMutex_;
+    std::thread reader_;
+};
+
+#endif //CPU8080_GDBSTUB_H
@@ -0,0 +1,163 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "idioms.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "emulator.h"
+#include "opcodes.h"
+
+namespace {
+
+bool jumpsTo(std::vector<Byte> const& memory, uint16_t at, uint16_t head) {
+    return memory[at] == 0xc2 && (memory[at + 1] | memory[at + 2] << 8) == head;
+}
+
+bool bumpsPointers(Byte first, Byte second) {
+    return (first == 0x13 && second == 0x23) || (first == 0x23 && second == 0x13);
+}
+
+IdiomMatch found(std::vector<Byte> const& memory, uint16_t head, Idiom idiom, Byte length) {
+    IdiomMatch match {idiom, length};
+    for (uint16_t pc = head; pc < head + length; pc += opcodes[memory[pc]].length) {
+        match.cycles += opcodes[memory[pc]].cycles;
+        ++match.ops;
+    }
+    return match;
+}
+
+Byte& counterRegister(Status& status, Byte dcr) {
+    switch (dcr) {
+        case 0x05: return status.b;
+        case 0x0d: return status.c;
+        case 0x15: return status.d;
+        default: return status.e;
+    }
+}
+
+// Whether the length bytes written from start, wrapping at 64K, reach into the code at head.
+bool overlaps(uint16_t start, uint32_t length, uint16_t head, Byte codeLength) {
+    return static_cast<uint16_t>(head - start) < length || static_cast<uint16_t>(start - head) < codeLength;
+}
+
+}
+
+void Idioms::setEnabled(bool enabled) {
+    enabled_ = enabled;
+    if (enabled_ && heads_.empty()) { heads_.assign(1 << 16, Idiom::UNKNOWN); }
+}
+
+IdiomMatch Idioms::recognize(std::vector<Byte> const& memory, uint16_t head) {
+    if (head > 0xfff0) { return {}; }     // Not worth handling code that wraps around.
+    Byte const* m = memory.data() + head;
+    if (m[0] == 0x1a && m[1] == 0x77 && bumpsPointers(m[2], m[3])) {
+        if ((m[4] == 0x05 || m[4] == 0x0d) && jumpsTo(memory, head + 5, head)) {
+            IdiomMatch match = found(memory, head, Idiom::COPY8, 8);
+            match.counter = m[4];
+            return match;
+        }
+        if (m[4] == 0x0b && ((m[5] == 0x78 && m[6] == 0xb1) || (m[5] == 0x79 && m[6] == 0xb0))
+                && jumpsTo(memory, head + 7, head)) {
+            return found(memory, head, Idiom::COPY16, 10);
+        }
+    }
+    if (m[0] == 0x77 && m[1] == 0x23 && (m[2] == 0x05 || m[2] == 0x0d || m[2] == 0x15 || m[2] == 0x1d)
+            && jumpsTo(memory, head + 3, head)) {
+        IdiomMatch match = found(memory, head, Idiom::FILL8, 6);
+        match.counter = m[2];
+        return match;
+    }
+    if (m[0] == 0x36 && m[2] == 0x23 && m[3] == 0x7c && m[4] == 0xfe && jumpsTo(memory, head + 6, head)) {
+        IdiomMatch match = found(memory, head, Idiom::FILL_UNTIL, 9);
+        match.value = m[1];
+        match.limit = m[5];
+        return match;
+    }
+    return {};
+}
+
+uint64_t Idioms::run(Emulator& emulator, uint64_t budget) {
+    Status& s = emulator.status_;
+    uint16_t const head = s.pc;
+    if (!enabled_ || heads_[head] == Idiom::NONE) { return 0; }
+    IdiomMatch const match = recognize(s.memory, head);
+    heads_[head] = match.idiom;
+    if (match.idiom == Idiom::NONE) { return 0; }
+
+    uint16_t const hl = s.hl;
+    uint16_t const de = s.de;
+    uint16_t const bc = s.bc;
+    uint32_t all;       // Iterations left until the JNZ falls through.
+    switch (match.idiom) {
+        case Idiom::COPY8:
+        case Idiom::FILL8: {
+            Byte const count = counterRegister(s, match.counter);
+            all = count ? count : 256;
+            break;
+        }
+        case Idiom::COPY16: all = bc ? bc : 1 << 16; break;
+        default: {
+            bool const next = (static_cast<uint16_t>(hl + 1) >> 8) == match.limit;
+            all = next ? 1 : static_cast<uint16_t>((match.limit << 8) - hl);
+            break;
+        }
+    }
+    uint32_t const n = std::min<uint64_t>(all, budget / match.cycles);
+    if (n == 0 || overlaps(hl, n, head, match.length)) { return 0; }
+
+    Byte* memory = s.memory.data();
+    bool const copies = match.idiom == Idiom::COPY8 || match.idiom == Idiom::COPY16;
+    if (copies) {
+        // Forward byte by byte, which only differs from memmove when the destination starts inside
+        // the source.
+        if (hl + n <= 1 << 16 && de + n <= 1 << 16 && (hl <= de || hl >= de + n)) {
+            std::memmove(memory + hl, memory + de, n);
+        } else {
+            for (uint32_t i = 0; i < n; ++i) { memory[static_cast<uint16_t>(hl + i)] = memory[static_cast<uint16_t>(de + i)]; }
+        }
+        s.de = de + n;
+        s.a = memory[static_cast<uint16_t>(hl + n - 1)];
+    } else {
+        Byte const value = match.idiom == Idiom::FILL8 ? s.a : match.value;
+        if (hl + n <= 1 << 16) {
+            std::memset(memory + hl, value, n);
+        } else {
+            for (uint32_t i = 0; i < n; ++i) { memory[static_cast<uint16_t>(hl + i)] = value; }
+        }
+    }
+    s.hl = hl + n;
+
+    // The flags come from the last iteration's DCR, ORA or CPI, run for real.
+    switch (match.idiom) {
+        case Idiom::COPY8:
+        case Idiom::FILL8: {
+            Byte& counter = counterRegister(s, match.counter);
+            counter = counter - n + 1;
+            emulator.dcr(counter);
+            break;
+        }
+        case Idiom::COPY16: {
+            s.bc = bc - n;
+            s.a = s.b;
+            emulator.ora(s.c);
+            break;
+        }
+        default:
+            s.a = s.h;
+            emulator.cmp(match.limit);
+            break;
+    }
+    s.cycles += static_cast<uint64_t>(n) * match.cycles;
+    if (n == all) { s.pc = head + match.length; }
+    ++loops_;
+    iterations_ += n;
+    ops_ += static_cast<uint64_t>(n) * match.ops;
+    return n;
+}
+
+void Idioms::forget() {
+    std::replace(heads_.begin(), heads_.end(), Idiom::NONE, Idiom::UNKNOWN);
+}
@@ -0,0 +1,73 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_IDIOMS_H
+#define CPU8080_IDIOMS_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "types.h"
+
+class Emulator;
+
+// The tight guest loops Idioms runs natively, each named after the loop it replaces:
+//   COPY8       LDAX D; MOV M,A; INX D; INX H; DCR B|C; JNZ head             (INX in either order)
+//   COPY16      LDAX D; MOV M,A; INX D; INX H; DCX B; MOV A,B; ORA C; JNZ head (or MOV A,C; ORA B)
+//   FILL8       MOV M,A; INX H; DCR B|C|D|E; JNZ head
+//   FILL_UNTIL  MVI M,value; INX H; MOV A,H; CPI limit; JNZ head
+enum class Idiom : uint8_t {
+    UNKNOWN,    // Not looked at yet.
+    NONE,
+    COPY8,
+    COPY16,
+    FILL8,
+    FILL_UNTIL,
+};
+
+// A loop found at a head address.
+struct IdiomMatch {
+    Idiom idiom {Idiom::NONE};
+    Byte length {0};    // Bytes of code from the head through the JNZ.
+    Byte cycles {0};    // States per iteration.
+    Byte ops {0};       // Ops per iteration.
+    Byte counter {0};   // The DCR opcode, for COPY8 and FILL8.
+    Byte value {0};     // The MVI operand, for FILL_UNTIL.
+    Byte limit {0};     // The CPI operand, for FILL_UNTIL.
+};
+
+// Block copy and fill loops recognized at their heads and run as a memmove or memset with the
+// registers, flags, memory and cycle count the interpreter would have left. Emulator::run looks here
+// after every taken backward branch while enabled and neither the debugger nor a profiler is
+// attached; only whole iterations that fit in the remaining cycle budget run natively, so a run
+// stops exactly where it would without idioms. Heads found to hold no idiom are remembered until
+// forget(); an idiom's code is matched again every time, so self-modifying code stays correct.
+class Idioms {
+public:
+    void setEnabled(bool enabled);
+    bool enabled() const { return enabled_; }
+
+    static IdiomMatch recognize(std::vector<Byte> const& memory, uint16_t head);
+
+    // Runs up to budget states of the loop whose head is at pc. Returns the iterations run, 0 when
+    // there is no idiom at pc or not one whole iteration fits, leaving everything as it was.
+    uint64_t run(Emulator& emulator, uint64_t budget);
+
+    // Drops what is remembered about heads without idioms, for new code.
+    void forget();
+
+    uint64_t loops() const { return loops_; }
+    uint64_t iterations() const { return iterations_; }
+    // The interpreter ops those iterations stood in for.
+    uint64_t ops() const { return ops_; }
+
+private:
+    std::vector<Idiom> heads_;
+    uint64_t loops_ {0};
+    uint64_t iterations_ {0};
+    uint64_t ops_ {0};
+    bool enabled_ {false};
+};
+
+#endif //CPU8080_IDIOMS_H
@@ -0,0 +1,53 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "inputscript.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+char const* const inputNames[] = {
+    "coin", "p1_start", "p2_start", "p1_fire", "p1_left", "p1_right", "p2_fire", "p2_left", "p2_right", "tilt",
+};
+
+}
+
+InputScript InputScript::parse(std::istream& in, std::string const& name) {
+    InputScript script;
+    std::string line;
+    for (int number = 1; std::getline(in, line); ++number) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        if (fields >> std::ws; fields.eof()) { continue; }
+        uint64_t frame = 0;
+        std::string input;
+        std::string state;
+        std::string rest;
+        fields >> frame >> input >> state;
+        auto const known = std::find(std::begin(inputNames), std::end(inputNames), input);
+        if (!fields || known == std::end(inputNames) || (state != "down" && state != "up") || fields >> rest) {
+            throw InputScriptError(name + ":" + std::to_string(number) + ": expected <frame> <input> <down | up>");
+        }
+        script.events_.push_back({frame, static_cast<Invaders::Input>(known - std::begin(inputNames)), state == "down"});
+    }
+    std::stable_sort(script.events_.begin(), script.events_.end(), [](Event const& a, Event const& b) {
+        return a.frame < b.frame;
+    });
+    return script;
+}
+
+InputScript InputScript::load(std::string const& filename) {
+    std::ifstream in(filename);
+    if (!in) { throw InputScriptError(filename + ": cannot open"); }
+    return parse(in, filename);
+}
+
+void InputScript::apply(uint64_t frame, Invaders& machine) {
+    for (; next_ < events_.size() && events_[next_].frame <= frame; ++next_) {
+        machine.setInput(events_[next_].input, events_[next_].pressed);
+    }
+}
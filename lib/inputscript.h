@@ -0,0 +1,45 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_INPUTSCRIPT_H
+#define CPU8080_INPUTSCRIPT_H
+
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "invaders.h"
+
+class InputScriptError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Presses and releases of the cabinet's controls by frame, to drive a run the same way every time,
+// e.g. while recording a movie. The text has one "<frame> <input> <down | up>" per line, inputs
+// named after Invaders::Input in lower case (coin, p1_start, p1_fire, p1_left, ..., tilt); '#'
+// starts a comment.
+class InputScript {
+public:
+    // Throws InputScriptError naming the first bad line.
+    static InputScript parse(std::istream& in, std::string const& name = "input");
+    static InputScript load(std::string const& filename);
+
+    // Makes the changes due up to frame on machine; call it before running each frame.
+    void apply(uint64_t frame, Invaders& machine);
+    size_t size() const { return events_.size(); }
+
+private:
+    struct Event {
+        uint64_t frame;
+        Invaders::Input input;
+        bool pressed;
+    };
+
+    std::vector<Event> events_;     // By frame, in file order within one.
+    size_t next_ {0};
+};
+
+#endif //CPU8080_INPUTSCRIPT_H
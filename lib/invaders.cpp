@@ -0,0 +1,93 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "invaders.h"
+
+#include <algorithm>
+
+#include "metrics.h"
+#include "sound.h"
+
+namespace {
+
+struct InputBit {
+    Byte port;
+    Byte mask;
+};
+
+constexpr InputBit inputBits[] = {
+    {1, 0x01},  // COIN
+    {1, 0x04},  // P1_START
+    {1, 0x02},  // P2_START
+    {1, 0x10},  // P1_FIRE
+    {1, 0x20},  // P1_LEFT
+    {1, 0x40},  // P1_RIGHT
+    {2, 0x10},  // P2_FIRE
+    {2, 0x20},  // P2_LEFT
+    {2, 0x40},  // P2_RIGHT
+    {2, 0x04},  // TILT
+};
+
+}
+
+void Invaders::attach(Emulator& emulator) {
+    emulator.setPorts(this);
+    emulator.setShiftRegister(&shifter_);
+}
+
+void Invaders::setInput(Input input, bool pressed) {
+    InputBit const bit = inputBits[input];
+    Byte& port = bit.port == 1 ? port1_ : port2_;
+    port = pressed ? port | bit.mask : port & ~bit.mask;
+}
+
+void Invaders::setShips(int ships) {
+    port2_ = (port2_ & ~0x03) | (std::clamp(ships, 3, 6) - 3);
+}
+
+Byte Invaders::in(Byte port, uint64_t) {
+    switch (port) {
+        case 0: return port0_;
+        case 1: return port1_;
+        case 2: return port2_;
+        case ShiftRegister::resultPort: return shifter_.result();
+        default: return 0;
+    }
+}
+
+void Invaders::out(Byte port, Byte value, uint64_t cycles) {
+    switch (port) {
+        case ShiftRegister::offsetPort: shifter_.setOffset(value); break;
+        case ShiftRegister::dataPort: shifter_.shiftIn(value); break;
+        case 3:
+        case 5:
+            if (sound_) { sound_->write(port, value, cycles); }
+            break;
+        default: break;
+    }
+}
+
+void Invaders::raise(Emulator& emulator, Byte vector, uint64_t due) {
+    uint64_t const late = emulator.status_.cycles - due;
+    bool const taken = emulator.interrupt(vector);
+    if (metrics_) { metrics_->recordInterrupt(taken, late); }
+}
+
+Stop Invaders::runFrame(Emulator& emulator) {
+    Status const& status = emulator.status_;
+    uint64_t const end = (frame(status.cycles) + 1) * cyclesPerFrame;
+    uint64_t const middle = end - cyclesPerFrame / 2;
+    if (status.cycles < middle) {
+        Stop const stop = emulator.run(middle - status.cycles);
+        if (stop.reason != StopReason::CYCLE_BUDGET) { return stop; }
+        raise(emulator, 1, middle);
+    }
+    if (status.cycles < end) {
+        Stop const stop = emulator.run(end - status.cycles);
+        if (stop.reason != StopReason::CYCLE_BUDGET) { return stop; }
+    }
+    raise(emulator, 2, end);
+    if (sound_) { sound_->advance(status.cycles); }
+    return {StopReason::CYCLE_BUDGET, status.pc, status.memory[status.pc]};
+}
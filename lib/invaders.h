@@ -0,0 +1,70 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_INVADERS_H
+#define CPU8080_INVADERS_H
+
+#include "emulator.h"
+#include "shiftregister.h"
+
+class InstanceMetrics;
+class SoundBoard;
+
+// The Space Invaders cabinet around the 8080: the controls and DIP switches on input ports 0-2,
+// the shift register on ports 2-4 and the two video interrupts of every 60 Hz frame, RST 1 at
+// mid-screen and RST 2 at the end.
+// Frames are counted from cycle 0, so where a frame starts depends only on the cycle count.
+// Writes to the sound ports 3 and 5 go to the sound board, if one is set.
+class Invaders : public Ports {
+public:
+    static constexpr uint64_t clockHz = 2000000;
+    static constexpr uint64_t cyclesPerFrame = clockHz / 60;
+
+    enum Input : uint8_t {
+        COIN,
+        P1_START,
+        P2_START,
+        P1_FIRE,
+        P1_LEFT,
+        P1_RIGHT,
+        P2_FIRE,
+        P2_LEFT,
+        P2_RIGHT,
+        TILT,
+    };
+
+    // Makes this emulator's ports, with the shift register handled inline by the emulator.
+    void attach(Emulator& emulator);
+
+    void setInput(Input input, bool pressed);
+    // Lives per game, 3 to 6.
+    void setShips(int ships);
+    // The board is advanced to the end of every frame.
+    void setSoundBoard(SoundBoard* board) { sound_ = board; }
+    // Gets the latency of every video interrupt, and each one dropped, if set.
+    void setMetrics(InstanceMetrics* metrics) { metrics_ = metrics; }
+
+    Byte in(Byte port, uint64_t cycles) override;
+    void out(Byte port, Byte value, uint64_t cycles) override;
+
+    // Runs emulator to the end of the current frame, raising the interrupts on the way. Returns
+    // early with the stop when the emulator stops for anything but its cycle budget; calling it
+    // again carries on with the same frame.
+    Stop runFrame(Emulator& emulator);
+    static uint64_t frame(uint64_t cycles) { return cycles / cyclesPerFrame; }
+    ShiftRegister& shiftRegister() { return shifter_; }
+
+private:
+    // Raises the interrupt that fell due at cycle due, which the last op may have run past.
+    void raise(Emulator& emulator, Byte vector, uint64_t due);
+
+    Byte port0_ {0x0e};     // Bits 1-3 always read 1.
+    Byte port1_ {0x08};     // Bit 3 always reads 1.
+    Byte port2_ {0x00};     // Three ships, extra ship at 1500, coin info shown.
+    ShiftRegister shifter_;
+    SoundBoard* sound_ {nullptr};
+    InstanceMetrics* metrics_ {nullptr};
+};
+
+#endif //CPU8080_INVADERS_H
@@ -0,0 +1,194 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "metrics.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <sstream>
+
+#include "emulator.h"
+#include "pacer.h"
+
+namespace {
+
+std::vector<double> const frameBounds {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.0167, 0.025, 0.05, 0.1};
+// The 8080's longest op takes 18 states, so anything above is a late interrupt.
+std::vector<double> const latencyBounds {0, 4, 7, 10, 11, 18, 100, 1000};
+
+std::string withLabel(std::string const& labels, std::string const& label) {
+    if (labels.empty()) { return "{" + label + "}"; }
+    return "{" + labels + "," + label + "}";
+}
+
+// The shortest text that reads back as value, without exponents; Prometheus spells the
+// non-finite ones NaN, +Inf and -Inf.
+std::string number(double value) {
+    if (std::isnan(value)) { return "NaN"; }
+    if (std::isinf(value)) { return value > 0 ? "+Inf" : "-Inf"; }
+    char text[400];
+    return {text, std::to_chars(text, text + sizeof text, value, std::chars_format::fixed).ptr};
+}
+
+std::string braced(std::string const& labels) {
+    return labels.empty() ? "" : "{" + labels + "}";
+}
+
+}
+
+size_t metrics_detail::threadSlot() {
+    static std::atomic<size_t> next {0};
+    thread_local size_t const slot = next.fetch_add(1, std::memory_order_relaxed) % slotCount;
+    return slot;
+}
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (Slot const& slot: slots_) { total += slot.value.load(std::memory_order_relaxed); }
+    return total;
+}
+
+Histogram::Histogram(std::vector<double> bounds): bounds_(std::move(bounds)) {
+    std::sort(bounds_.begin(), bounds_.end());
+    for (Slot& slot: slots_) { slot.counts = std::vector<std::atomic<uint64_t>>(bounds_.size() + 1); }
+}
+
+void Histogram::observe(double value) {
+    Slot& slot = slots_[metrics_detail::threadSlot()];
+    size_t const bucket = std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin();
+    slot.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    slot.sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> Histogram::counts() const {
+    std::vector<uint64_t> counts(bounds_.size() + 1, 0);
+    for (Slot const& slot: slots_) {
+        for (size_t i = 0; i < counts.size(); ++i) { counts[i] += slot.counts[i].load(std::memory_order_relaxed); }
+    }
+    return counts;
+}
+
+uint64_t Histogram::count() const {
+    uint64_t total = 0;
+    for (uint64_t n: counts()) { total += n; }
+    return total;
+}
+
+double Histogram::sum() const {
+    double total = 0;
+    for (Slot const& slot: slots_) { total += slot.sum.load(std::memory_order_relaxed); }
+    return total;
+}
+
+Metrics::Entry* Metrics::find(std::string const& name, std::string const& labels, Type type) {
+    for (Entry& entry: entries_) {
+        if (entry.name != name || entry.labels != labels) { continue; }
+        if (entry.type != type) { throw MetricsError("metric " + name + braced(labels) + " registered with another type"); }
+        return &entry;
+    }
+    return nullptr;
+}
+
+Counter& Metrics::counter(std::string const& name, std::string const& help, std::string const& labels) {
+    std::lock_guard lock(mutex_);
+    if (Entry* entry = find(name, labels, Type::COUNTER)) { return *entry->counter; }
+    entries_.push_back({name, help, labels, Type::COUNTER, &counters_.emplace_back()});
+    return *entries_.back().counter;
+}
+
+Gauge& Metrics::gauge(std::string const& name, std::string const& help, std::string const& labels) {
+    std::lock_guard lock(mutex_);
+    if (Entry* entry = find(name, labels, Type::GAUGE)) { return *entry->gauge; }
+    entries_.push_back({name, help, labels, Type::GAUGE, nullptr, &gauges_.emplace_back()});
+    return *entries_.back().gauge;
+}
+
+Histogram& Metrics::histogram(std::string const& name, std::string const& help, std::vector<double> const& bounds,
+                              std::string const& labels) {
+    std::lock_guard lock(mutex_);
+    if (Entry* entry = find(name, labels, Type::HISTOGRAM)) { return *entry->histogram; }
+    entries_.push_back({name, help, labels, Type::HISTOGRAM, nullptr, nullptr, &histograms_.emplace_back(bounds)});
+    return *entries_.back().histogram;
+}
+
+std::string Metrics::prometheus() const {
+    std::lock_guard lock(mutex_);
+    std::ostringstream out;
+    std::vector<std::string> written;
+    for (Entry const& first: entries_) {
+        if (std::find(written.begin(), written.end(), first.name) != written.end()) { continue; }
+        written.push_back(first.name);
+        char const* const type = first.type == Type::COUNTER ? "counter" : first.type == Type::GAUGE ? "gauge" : "histogram";
+        out << "# HELP " << first.name << ' ' << first.help << "\n# TYPE " << first.name << ' ' << type << '\n';
+        for (Entry const& entry: entries_) {
+            if (entry.name != first.name) { continue; }
+            switch (entry.type) {
+                case Type::COUNTER: out << entry.name << braced(entry.labels) << ' ' << entry.counter->value() << '\n'; break;
+                case Type::GAUGE: out << entry.name << braced(entry.labels) << ' ' << number(entry.gauge->value()) << '\n'; break;
+                case Type::HISTOGRAM: {
+                    Histogram const& histogram = *entry.histogram;
+                    std::vector<uint64_t> const counts = histogram.counts();
+                    uint64_t cumulative = 0;
+                    for (size_t i = 0; i < counts.size(); ++i) {
+                        cumulative += counts[i];
+                        std::string const bound = i < histogram.bounds().size() ? number(histogram.bounds()[i]) : "+Inf";
+                        out << entry.name << "_bucket" << withLabel(entry.labels, "le=\"" + bound + "\"") << ' '
+                            << cumulative << '\n';
+                    }
+                    out << entry.name << "_sum" << braced(entry.labels) << ' ' << number(histogram.sum()) << '\n';
+                    out << entry.name << "_count" << braced(entry.labels) << ' ' << cumulative << '\n';
+                    break;
+                }
+            }
+        }
+    }
+    return out.str();
+}
+
+InstanceMetrics::InstanceMetrics(Metrics& metrics, std::string const& instance, double targetCyclesPerSecond):
+        instructions_(metrics.counter("cpu8080_instructions_total", "Emulated 8080 ops run.", "instance=\"" + instance + "\"")),
+        cycles_(metrics.counter("cpu8080_cycles_total", "Emulated 8080 states run.", "instance=\"" + instance + "\"")),
+        targetCyclesPerSecond_(metrics.gauge("cpu8080_target_cycles_per_second", "States per second of the emulated clock.",
+                                             "instance=\"" + instance + "\"")),
+        frameSeconds_(metrics.histogram("cpu8080_frame_seconds", "Host time spent emulating each frame, pacing excluded.",
+                                        frameBounds, "instance=\"" + instance + "\"")),
+        interruptLatency_(metrics.histogram("cpu8080_interrupt_latency_states",
+                                            "Emulated states between an interrupt falling due and being taken.",
+                                            latencyBounds, "instance=\"" + instance + "\"")),
+        interruptsDropped_(metrics.counter("cpu8080_interrupts_dropped_total",
+                                           "Interrupts that fell due while the 8080 had them disabled.",
+                                           "instance=\"" + instance + "\"")),
+        unimplemented_(metrics.counter("cpu8080_unimplemented_opcodes_total", "Unimplemented opcodes met.",
+                                       "instance=\"" + instance + "\"")),
+        missedFrames_(metrics.counter("cpu8080_missed_frames_total", "Frames that ended after their real-time deadline.",
+                                      "instance=\"" + instance + "\"")),
+        resyncs_(metrics.counter("cpu8080_pacer_resyncs_total", "Times pacing fell too far behind and restarted.",
+                                 "instance=\"" + instance + "\"")) {
+    targetCyclesPerSecond_.set(targetCyclesPerSecond);
+}
+
+void InstanceMetrics::recordFrame(Emulator const& emulator, double seconds, PacerStats const* pacer) {
+    instructions_.add(emulator.ops() - lastOps_);
+    lastOps_ = emulator.ops();
+    cycles_.add(emulator.status_.cycles - lastCycles_);
+    lastCycles_ = emulator.status_.cycles;
+    unimplemented_.add(emulator.unimplementedHits() - lastUnimplemented_);
+    lastUnimplemented_ = emulator.unimplementedHits();
+    frameSeconds_.observe(seconds);
+    if (pacer) {
+        missedFrames_.add(pacer->missed - lastMissed_);
+        lastMissed_ = pacer->missed;
+        resyncs_.add(pacer->resyncs - lastResyncs_);
+        lastResyncs_ = pacer->resyncs;
+    }
+}
+
+void InstanceMetrics::recordInterrupt(bool taken, uint64_t lateStates) {
+    if (taken) {
+        interruptLatency_.observe(static_cast<double>(lateStates));
+    } else {
+        interruptsDropped_.add();
+    }
+}
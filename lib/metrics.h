@@ -0,0 +1,146 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_METRICS_H
+#define CPU8080_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class Emulator;
+struct PacerStats;
+
+class MetricsError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+namespace metrics_detail {
+
+constexpr size_t slotCount = 16;
+
+// This thread's slot: threads take slots round-robin on first use, so up to slotCount threads
+// never share one.
+size_t threadSlot();
+
+}
+
+// A count that only goes up. Each thread adds to its own cache line with a relaxed atomic add;
+// value() sums the lines.
+class Counter {
+public:
+    void add(uint64_t n = 1) { slots_[metrics_detail::threadSlot()].value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const;
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> value {0};
+    };
+    std::array<Slot, metrics_detail::slotCount> slots_ {};
+};
+
+// A value that is set, last writer wins.
+class Gauge {
+public:
+    void set(double value) { value_.store(value, std::memory_order_relaxed); }
+    double value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> value_ {0};
+};
+
+// Observations counted into buckets by fixed upper bounds, sharded per thread like Counter.
+class Histogram {
+public:
+    explicit Histogram(std::vector<double> bounds);
+
+    void observe(double value);
+    std::vector<double> const& bounds() const { return bounds_; }
+    // Per bucket, not cumulative; the last is above every bound.
+    std::vector<uint64_t> counts() const;
+    uint64_t count() const;
+    double sum() const;
+
+private:
+    struct alignas(64) Slot {
+        std::vector<std::atomic<uint64_t>> counts;
+        std::atomic<double> sum {0};
+    };
+
+    std::vector<double> bounds_;
+    std::array<Slot, metrics_detail::slotCount> slots_;
+};
+
+// Named metrics, each with an optional label set such as instance="0", exported in the Prometheus
+// text format. Registering takes a lock and returns the same metric for the same name and labels;
+// updating one never does, so the handles are meant to be looked up once and kept.
+class Metrics {
+public:
+    // Throw MetricsError when the name and labels are already taken by another type of metric.
+    Counter& counter(std::string const& name, std::string const& help, std::string const& labels = "");
+    Gauge& gauge(std::string const& name, std::string const& help, std::string const& labels = "");
+    Histogram& histogram(std::string const& name, std::string const& help, std::vector<double> const& bounds,
+                         std::string const& labels = "");
+
+    // Version 0.0.4 of the exposition format, metrics grouped by name in registration order.
+    std::string prometheus() const;
+
+private:
+    enum class Type : uint8_t { COUNTER, GAUGE, HISTOGRAM };
+
+    struct Entry {
+        std::string name;
+        std::string help;
+        std::string labels;
+        Type type;
+        Counter* counter {nullptr};
+        Gauge* gauge {nullptr};
+        Histogram* histogram {nullptr};
+    };
+
+    Entry* find(std::string const& name, std::string const& labels, Type type);
+
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+    std::deque<Counter> counters_;          // Deques, so handles stay put as more are added.
+    std::deque<Gauge> gauges_;
+    std::deque<Histogram> histograms_;
+};
+
+// The telemetry of one running machine, labelled instance="<id>". The run loop is left alone:
+// recordFrame takes what the emulator and pacer already count, once per frame.
+class InstanceMetrics {
+public:
+    InstanceMetrics(Metrics& metrics, std::string const& instance, double targetCyclesPerSecond);
+
+    // After each frame, with the host time spent emulating it and the pacer's stats, if paced.
+    void recordFrame(Emulator const& emulator, double seconds, PacerStats const* pacer = nullptr);
+    // A due interrupt, taken lateStates after it was due or dropped because interrupts were disabled.
+    void recordInterrupt(bool taken, uint64_t lateStates);
+
+private:
+    Counter& instructions_;
+    Counter& cycles_;
+    Gauge& targetCyclesPerSecond_;
+    Histogram& frameSeconds_;
+    Histogram& interruptLatency_;
+    Counter& interruptsDropped_;
+    Counter& unimplemented_;
+    Counter& missedFrames_;
+    Counter& resyncs_;
+
+    uint64_t lastOps_ {0};
+    uint64_t lastCycles_ {0};
+    uint64_t lastUnimplemented_ {0};
+    uint64_t lastMissed_ {0};
+    uint64_t lastResyncs_ {0};
+};
+
+#endif //CPU8080_METRICS_H
@@ -0,0 +1,124 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "metricsserver.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t maxRequest = 8192;
+
+[[noreturn]] void fail(std::string const& what) {
+    throw MetricsError(what + ": " + std::strerror(errno));
+}
+
+void sendAll(int fd, std::string const& bytes) {
+    for (size_t sent = 0; sent < bytes.size();) {
+        ssize_t const count = send(fd, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR) { continue; }
+        if (count <= 0) { return; }
+        sent += count;
+    }
+}
+
+std::string response(char const* status, char const* type, std::string const& body) {
+    return std::string("HTTP/1.1 ") + status + "\r\nContent-Type: " + type + "\r\nContent-Length: "
+            + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+}
+
+}
+
+MetricsServer::MetricsServer(Metrics const& metrics, uint16_t port): metrics_(metrics) {
+    listenFd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd_ < 0) { fail("metrics socket"); }
+    int const reuse = 1;
+    setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof reuse);
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    socklen_t length = sizeof address;
+    if (bind(listenFd_, reinterpret_cast<sockaddr*>(&address), length) < 0
+            || getsockname(listenFd_, reinterpret_cast<sockaddr*>(&address), &length) < 0) {
+        close(listenFd_);
+        fail("metrics bind to port " + std::to_string(port));
+    }
+    port_ = ntohs(address.sin_port);
+    start();
+}
+
+MetricsServer::MetricsServer(Metrics const& metrics, std::string const& unixPath): metrics_(metrics), unixPath_(unixPath) {
+    sockaddr_un address {};
+    if (unixPath.size() >= sizeof address.sun_path) { throw MetricsError("metrics socket path too long: " + unixPath); }
+    listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd_ < 0) { fail("metrics socket"); }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, unixPath.c_str(), unixPath.size() + 1);
+    unlink(unixPath.c_str());
+    if (bind(listenFd_, reinterpret_cast<sockaddr*>(&address), sizeof address) < 0) {
+        close(listenFd_);
+        fail("metrics bind to " + unixPath);
+    }
+    start();
+}
+
+void MetricsServer::start() {
+    if (listen(listenFd_, 8) < 0) {
+        close(listenFd_);
+        fail("metrics listen");
+    }
+    thread_ = std::thread(&MetricsServer::serveLoop, this);
+}
+
+MetricsServer::~MetricsServer() {
+    stopping_ = true;
+    shutdown(listenFd_, SHUT_RDWR);
+    thread_.join();
+    close(listenFd_);
+    if (!unixPath_.empty()) { unlink(unixPath_.c_str()); }
+}
+
+void MetricsServer::serveLoop() {
+    while (!stopping_) {
+        int const client = accept(listenFd_, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR) { continue; }
+            break;
+        }
+        answer(client);
+        close(client);
+    }
+}
+
+// Reads the request head and answers it; a client that sends nothing gets dropped after a second.
+void MetricsServer::answer(int clientFd) {
+    timeval const timeout {1, 0};
+    setsockopt(clientFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof timeout);
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < maxRequest) {
+        ssize_t const count = recv(clientFd, buffer, sizeof buffer, 0);
+        if (count < 0 && errno == EINTR) { continue; }
+        if (count <= 0) { break; }
+        request.append(buffer, count);
+    }
+    if (request.compare(0, 4, "GET ") != 0) {
+        sendAll(clientFd, response("405 Method Not Allowed", "text/plain", "only GET /metrics\n"));
+        return;
+    }
+    std::string const path = request.substr(4, request.find_first_of(" \r\n", 4) - 4);
+    if (path != "/metrics" && path != "/") {
+        sendAll(clientFd, response("404 Not Found", "text/plain", "see /metrics\n"));
+        return;
+    }
+    sendAll(clientFd, response("200 OK", "text/plain; version=0.0.4", metrics_.prometheus()));
+}
@@ -0,0 +1,42 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_METRICSSERVER_H
+#define CPU8080_METRICSSERVER_H
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "metrics.h"
+
+// Serves Metrics::prometheus() to GET /metrics over HTTP, on 127.0.0.1 or a Unix domain socket. A
+// background thread answers one connection at a time and closes it; a scrape takes the registry's
+// lock and sums the counters, so the threads updating them never wait on it.
+class MetricsServer {
+public:
+    // Listens on 127.0.0.1:port; 0 picks a free port, see port(). Throws MetricsError.
+    MetricsServer(Metrics const& metrics, uint16_t port);
+    // Listens on a Unix domain socket at path, replacing any stale socket file. Throws MetricsError.
+    MetricsServer(Metrics const& metrics, std::string const& unixPath);
+    MetricsServer(MetricsServer const&) = delete;
+    MetricsServer& operator=(MetricsServer const&) = delete;
+    ~MetricsServer();
+
+    uint16_t port() const { return port_; }
+
+private:
+    void start();
+    void serveLoop();
+    void answer(int clientFd);
+
+    Metrics const& metrics_;
+    int listenFd_ {-1};
+    uint16_t port_ {0};
+    std::string unixPath_;
+    std::atomic<bool> stopping_ {false};
+    std::thread thread_;
+};
+
+#endif //CPU8080_METRICSSERVER_H
@@ -0,0 +1,180 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "movie.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+constexpr char magic[8] = {'8', '0', '8', '0', 'M', 'O', 'V', '1'};
+
+void putWord(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) { out += static_cast<char>(value >> (8 * i)); }
+}
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>(value | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+class Reader {
+public:
+    Reader(std::string const& filename, std::string const& bytes): filename_(filename), bytes_(bytes) {}
+
+    Byte byte() {
+        if (pos_ >= bytes_.size()) { throw MovieError(filename_ + ": truncated"); }
+        return bytes_[pos_++];
+    }
+
+    uint64_t word() {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) { value |= uint64_t {byte()} << (8 * i); }
+        return value;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            Byte const b = byte();
+            value |= uint64_t {b & 0x7fu} << shift;
+            if (!(b & 0x80)) { return value; }
+        }
+        throw MovieError(filename_ + ": bad cycle delta");
+    }
+
+    bool done() const { return pos_ == bytes_.size(); }
+
+private:
+    std::string const& filename_;
+    std::string const& bytes_;
+    size_t pos_ {0};
+};
+
+}
+
+void Movie::save(std::string const& filename) const {
+    std::string out(magic, sizeof magic);
+    for (int port = 0; port < 256; port += 8) {
+        Byte mask = 0;
+        for (int bit = 0; bit < 8; ++bit) { mask |= ports[port + bit] << bit; }
+        out += static_cast<char>(mask);
+    }
+    putWord(out, endCycles);
+    putWord(out, endHash);
+    putWord(out, reads.size());
+    uint64_t cycles = 0;
+    for (Read const& read: reads) {
+        putVarint(out, read.cycles - cycles);
+        out += static_cast<char>(read.port);
+        out += static_cast<char>(read.value);
+        cycles = read.cycles;
+    }
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    file.write(out.data(), out.size());
+    if (!file) { throw MovieError(filename + ": cannot write movie"); }
+}
+
+Movie Movie::load(std::string const& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) { throw MovieError(filename + ": cannot open movie"); }
+    std::string const bytes {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    if (bytes.size() < sizeof magic || std::memcmp(bytes.data(), magic, sizeof magic) != 0) {
+        throw MovieError(filename + ": not a movie file");
+    }
+
+    Reader reader(filename, bytes);
+    for (size_t i = 0; i < sizeof magic; ++i) { reader.byte(); }
+    Movie movie;
+    for (int port = 0; port < 256; port += 8) {
+        Byte const mask = reader.byte();
+        for (int bit = 0; bit < 8; ++bit) { movie.ports[port + bit] = (mask >> bit) & 1; }
+    }
+    movie.endCycles = reader.word();
+    movie.endHash = reader.word();
+    uint64_t const count = reader.word();
+    if (count > bytes.size()) { throw MovieError(filename + ": truncated"); }
+    movie.reads.reserve(count);
+    uint64_t cycles = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        cycles += reader.varint();
+        Byte const port = reader.byte();
+        movie.reads.push_back({cycles, port, reader.byte()});
+    }
+    if (!reader.done()) { throw MovieError(filename + ": trailing data"); }
+    return movie;
+}
+
+uint64_t stateHash(Emulator const& emulator) {
+    Status const& s = emulator.status_;
+    uint64_t hash = 0xcbf29ce484222325;
+    auto mix = [&hash](uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            hash = (hash ^ ((value >> (8 * i)) & 0xff)) * 0x100000001b3;
+        }
+    };
+    for (Byte r: {s.a, s.b, s.c, s.d, s.e, s.h, s.l, emulator.psw()}) { mix(r, 1); }
+    mix(s.sp, 2);
+    mix(s.pc, 2);
+    mix(s.cycles, 8);
+    mix(s.is_interrupt_enabled, 1);
+    for (Byte b: s.memory) { mix(b, 1); }
+    return hash;
+}
+
+MovieRecorder::MovieRecorder(Ports& device, std::bitset<256> ports): device_(device) {
+    movie_.ports = ports;
+    last_.fill(-1);
+}
+
+Byte MovieRecorder::in(Byte port, uint64_t cycles) {
+    Byte const value = device_.in(port, cycles);
+    if (movie_.ports[port] && last_[port] != value) {
+        movie_.reads.push_back({cycles, port, value});
+        last_[port] = value;
+    }
+    return value;
+}
+
+void MovieRecorder::out(Byte port, Byte value, uint64_t cycles) {
+    device_.out(port, value, cycles);
+}
+
+Movie MovieRecorder::finish(Emulator const& emulator) const {
+    Movie movie = movie_;
+    movie.endCycles = emulator.status_.cycles;
+    movie.endHash = stateHash(emulator);
+    return movie;
+}
+
+MoviePlayer::MoviePlayer(Movie const& movie, Ports& device): device_(device), ports_(movie.ports) {
+    for (Movie::Read const& read: movie.reads) { changes_[read.port].push_back({read.cycles, read.value}); }
+}
+
+Byte MoviePlayer::in(Byte port, uint64_t cycles) {
+    if (!ports_[port]) { return device_.in(port, cycles); }
+    auto const& changes = changes_[port];
+    size_t& cursor = cursors_[port];
+    if (cursor >= changes.size() || changes[cursor].cycles > cycles) {
+        // Further back than the last read, after a seek: find the change in effect from scratch.
+        auto const after = std::upper_bound(changes.begin(), changes.end(), cycles, [](uint64_t c, Change const& change) {
+            return c < change.cycles;
+        });
+        if (after == changes.begin()) { return device_.in(port, cycles); }    // Never read this early.
+        cursor = after - changes.begin() - 1;
+    }
+    while (cursor + 1 < changes.size() && changes[cursor + 1].cycles <= cycles) { ++cursor; }
+    return changes[cursor].value;
+}
+
+void MoviePlayer::out(Byte port, Byte value, uint64_t cycles) {
+    device_.out(port, value, cycles);
+}
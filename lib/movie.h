@@ -0,0 +1,84 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_MOVIE_H
+#define CPU8080_MOVIE_H
+
+#include <array>
+#include <bitset>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "emulator.h"
+
+class MovieError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// The IN reads of a recorded session, enough to replay it bit for bit: the emulator is otherwise
+// deterministic, so the same program reads the same ports at the same cycle counts. Only reads
+// that return something other than the previous read of the same port are kept.
+struct Movie {
+    struct Read {
+        uint64_t cycles;
+        Byte port;
+        Byte value;
+    };
+
+    std::bitset<256> ports;     // The recorded ports; reads of the others go to the device.
+    uint64_t endCycles {0};     // Where the session ended.
+    uint64_t endHash {0};       // stateHash() at endCycles, to tell a faithful replay.
+    std::vector<Read> reads;    // In cycle order.
+
+    // Cycle deltas are stored as LEB128, so a read costs three bytes or so. Throws MovieError.
+    void save(std::string const& filename) const;
+    static Movie load(std::string const& filename);
+};
+
+// FNV-1a over the registers, flags, cycle count and memory.
+uint64_t stateHash(Emulator const& emulator);
+
+// Passes every IN and OUT on to device, recording the reads of the given ports. Reads must come in
+// cycle order, so do not seek a Timeline while recording.
+class MovieRecorder : public Ports {
+public:
+    explicit MovieRecorder(Ports& device, std::bitset<256> ports = std::bitset<256>().set());
+
+    Byte in(Byte port, uint64_t cycles) override;
+    void out(Byte port, Byte value, uint64_t cycles) override;
+
+    // The movie so far, ending where emulator is now.
+    Movie finish(Emulator const& emulator) const;
+
+private:
+    Ports& device_;
+    Movie movie_;
+    std::array<int, 256> last_;     // The value of the last read per port, -1 before the first.
+};
+
+// Answers reads of the recorded ports from movie and passes everything else on to device. Reads
+// are looked up by cycle count rather than in order, so re-executing a stretch of the session
+// (Timeline::seek) sees the same values again.
+class MoviePlayer : public Ports {
+public:
+    MoviePlayer(Movie const& movie, Ports& device);
+
+    Byte in(Byte port, uint64_t cycles) override;
+    void out(Byte port, Byte value, uint64_t cycles) override;
+
+private:
+    struct Change {
+        uint64_t cycles;
+        Byte value;
+    };
+
+    Ports& device_;
+    std::bitset<256> ports_;
+    std::array<std::vector<Change>, 256> changes_;
+    std::array<size_t, 256> cursors_ {};    // Per port, the change the last read found.
+};
+
+#endif //CPU8080_MOVIE_H
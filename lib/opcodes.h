@@ -0,0 +1,187 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_OPCODES_H
+#define CPU8080_OPCODES_H
+
+#include <array>
+#include <stdint.h>
+
+#include "types.h"
+
+// Kind of the immediate bytes following an opcode.
+enum OperandKind : uint8_t { OPERAND_NONE, OPERAND_DATA8, OPERAND_DATA16, OPERAND_ADDRESS, OPERAND_PORT };
+
+// How an instruction affects the program counter beyond falling through.
+enum FlowKind : uint8_t {
+    FLOW_NONE,
+    FLOW_JUMP,
+    FLOW_COND_JUMP,
+    FLOW_CALL,
+    FLOW_COND_CALL,
+    FLOW_RET,
+    FLOW_COND_RET,
+    FLOW_RST,
+    FLOW_INDIRECT,  // PCHL
+    FLOW_HALT
+};
+
+enum FlagMask : uint8_t {
+    FLAG_NONE = 0,
+    FLAG_S = 1 << 0,
+    FLAG_Z = 1 << 1,
+    FLAG_AC = 1 << 2,
+    FLAG_P = 1 << 3,
+    FLAG_CY = 1 << 4,
+    FLAG_SZAP = FLAG_S | FLAG_Z | FLAG_AC | FLAG_P,
+    FLAG_ALL = FLAG_SZAP | FLAG_CY
+};
+
+struct OpInfo {
+    char text[16] {};          // Mnemonic, registers and immediate prefix, e.g. "MOV B,C", "MVI B,#$" or "JMP $".
+    uint8_t textLength {0};
+    uint8_t length {1};        // Bytes including the opcode.
+    OperandKind operand {OPERAND_NONE};
+    uint8_t cycles {4};        // States when a conditional branch is not taken.
+    uint8_t cyclesTaken {4};   // States when a conditional branch is taken.
+    uint8_t flags {FLAG_NONE};
+    FlowKind flow {FLOW_NONE};
+};
+
+namespace opcodes_detail {
+
+constexpr char const* regs[8] = {"B", "C", "D", "E", "H", "L", "M", "A"};
+constexpr char const* pairs[4] = {"B", "D", "H", "SP"};
+constexpr char const* stackPairs[4] = {"B", "D", "H", "PSW"};
+constexpr char const* conds[8] = {"NZ", "Z", "NC", "C", "PO", "PE", "P", "M"};
+constexpr char const* alu[8] = {"ADD", "ADC", "SUB", "SBB", "ANA", "XRA", "ORA", "CMP"};
+constexpr char const* aluImmediate[8] = {"ADI", "ACI", "SUI", "SBI", "ANI", "XRI", "ORI", "CPI"};
+constexpr char const* digits[8] = {"0", "1", "2", "3", "4", "5", "6", "7"};
+
+constexpr OpInfo makeOp(char const* a, char const* b = "", char const* c = "", char const* d = "") {
+    OpInfo info {};
+    int n = 0;
+    for (char const* part: {a, b, c, d}) {
+        while (*part) { info.text[n++] = *part++; }
+    }
+    info.textLength = n;
+    return info;
+}
+
+constexpr OpInfo withOperand(OpInfo info, OperandKind operand) {
+    for (char const* c = operand == OPERAND_ADDRESS ? "$" : "#$"; *c; ++c) { info.text[info.textLength++] = *c; }
+    info.operand = operand;
+    info.length = operand == OPERAND_NONE ? 1 : (operand == OPERAND_DATA16 || operand == OPERAND_ADDRESS ? 3 : 2);
+    return info;
+}
+
+constexpr OpInfo timed(OpInfo info, uint8_t cycles, uint8_t cyclesTaken = 0) {
+    info.cycles = cycles;
+    info.cyclesTaken = cyclesTaken ? cyclesTaken : cycles;
+    return info;
+}
+
+constexpr OpInfo affecting(OpInfo info, uint8_t flags) {
+    info.flags = flags;
+    return info;
+}
+
+constexpr OpInfo flowing(OpInfo info, FlowKind flow) {
+    info.flow = flow;
+    return info;
+}
+
+// Decodes the opcode through its xx yyy zzz bit fields, the way the 8080 datasheet groups them.
+constexpr OpInfo decode(Byte op) {
+    int const x = op >> 6;
+    int const y = (op >> 3) & 7;
+    int const z = op & 7;
+    int const p = y >> 1;
+    bool const mem = y == 6;
+
+    if (x == 1) {
+        if (op == 0x76) { return flowing(timed(makeOp("HLT"), 7), FLOW_HALT); }
+        return timed(makeOp("MOV ", regs[y], ",", regs[z]), (y == 6 || z == 6) ? 7 : 5);
+    }
+    if (x == 2) {
+        return affecting(timed(makeOp(alu[y], " ", regs[z]), z == 6 ? 7 : 4), FLAG_ALL);
+    }
+    if (x == 0) {
+        switch (z) {
+            case 0: return timed(makeOp(op ? "*NOP" : "NOP"), 4);
+            case 1:
+                if (y & 1) { return affecting(timed(makeOp("DAD ", pairs[p]), 10), FLAG_CY); }
+                return withOperand(timed(makeOp("LXI ", pairs[p], ","), 10), OPERAND_DATA16);
+            case 2:
+                switch (y) {
+                    case 0: case 2: return timed(makeOp("STAX ", pairs[p]), 7);
+                    case 1: case 3: return timed(makeOp("LDAX ", pairs[p]), 7);
+                    case 4: return withOperand(timed(makeOp("SHLD "), 16), OPERAND_ADDRESS);
+                    case 5: return withOperand(timed(makeOp("LHLD "), 16), OPERAND_ADDRESS);
+                    case 6: return withOperand(timed(makeOp("STA "), 13), OPERAND_ADDRESS);
+                    default: return withOperand(timed(makeOp("LDA "), 13), OPERAND_ADDRESS);
+                }
+            case 3: return timed(makeOp((y & 1) ? "DCX " : "INX ", pairs[p]), 5);
+            case 4: return affecting(timed(makeOp("INR ", regs[y]), mem ? 10 : 5), FLAG_SZAP);
+            case 5: return affecting(timed(makeOp("DCR ", regs[y]), mem ? 10 : 5), FLAG_SZAP);
+            case 6: return withOperand(timed(makeOp("MVI ", regs[y], ","), mem ? 10 : 7), OPERAND_DATA8);
+            default: {
+                constexpr char const* misc[8] = {"RLC", "RRC", "RAL", "RAR", "DAA", "CMA", "STC", "CMC"};
+                uint8_t flags = y < 4 || y > 5 ? FLAG_CY : (y == 4 ? FLAG_ALL : FLAG_NONE);
+                return affecting(timed(makeOp(misc[y]), 4), flags);
+            }
+        }
+    }
+
+    switch (z) {
+        case 0: return flowing(timed(makeOp("R", conds[y]), 5, 11), FLOW_COND_RET);
+        case 1:
+            switch (y) {
+                case 1: return flowing(timed(makeOp("RET"), 10), FLOW_RET);
+                case 3: return flowing(timed(makeOp("*RET"), 10), FLOW_RET);
+                case 5: return flowing(timed(makeOp("PCHL"), 5), FLOW_INDIRECT);
+                case 7: return timed(makeOp("SPHL"), 5);
+                default: return affecting(timed(makeOp("POP ", stackPairs[p]), 10), p == 3 ? FLAG_ALL : FLAG_NONE);
+            }
+        case 2: return flowing(withOperand(timed(makeOp("J", conds[y], " "), 10), OPERAND_ADDRESS), FLOW_COND_JUMP);
+        case 3:
+            switch (y) {
+                case 0: return flowing(withOperand(timed(makeOp("JMP "), 10), OPERAND_ADDRESS), FLOW_JUMP);
+                case 1: return flowing(withOperand(timed(makeOp("*JMP "), 10), OPERAND_ADDRESS), FLOW_JUMP);
+                case 2: return withOperand(timed(makeOp("OUT "), 10), OPERAND_PORT);
+                case 3: return withOperand(timed(makeOp("IN "), 10), OPERAND_PORT);
+                case 4: return timed(makeOp("XTHL"), 18);
+                case 5: return timed(makeOp("XCHG"), 4);
+                case 6: return timed(makeOp("DI"), 4);
+                default: return timed(makeOp("EI"), 4);
+            }
+        case 4: return flowing(withOperand(timed(makeOp("C", conds[y], " "), 11, 17), OPERAND_ADDRESS), FLOW_COND_CALL);
+        case 5:
+            if (y & 1) {
+                return flowing(withOperand(timed(makeOp(y == 1 ? "CALL " : "*CALL "), 17), OPERAND_ADDRESS), FLOW_CALL);
+            }
+            return timed(makeOp("PUSH ", stackPairs[p]), 11);
+        case 6: return affecting(withOperand(timed(makeOp(aluImmediate[y], " "), 7), OPERAND_DATA8), FLAG_ALL);
+        default: return flowing(timed(makeOp("RST ", digits[y]), 11), FLOW_RST);
+    }
+}
+
+constexpr std::array<OpInfo, 256> makeTable() {
+    std::array<OpInfo, 256> table {};
+    for (int op = 0; op < 256; ++op) {
+        table[op] = decode(static_cast<Byte>(op));
+    }
+    return table;
+}
+
+} // namespace opcodes_detail
+
+// Metadata for every 8080 opcode, shared by the Disassembler and the Emulator's decoder.
+inline constexpr std::array<OpInfo, 256> opcodes = opcodes_detail::makeTable();
+
+static_assert(opcodes[0xc3].length == 3 && opcodes[0xc3].flow == FLOW_JUMP, "JMP decodes as a 3-byte jump");
+static_assert(opcodes[0x76].flow == FLOW_HALT, "HLT sits in the middle of the MOV block");
+static_assert(opcodes[0xc4].cycles == 11 && opcodes[0xc4].cyclesTaken == 17, "CNZ timing");
+
+#endif //CPU8080_OPCODES_H
@@ -0,0 +1,81 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "pacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+using std::chrono::microseconds;
+
+constexpr microseconds minSpinMargin {20};
+
+double toMicroseconds(Pacer::Clock::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+}
+
+std::string PacerStats::describe() const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << frames << " frames, " << missed << " missed, " << resyncs
+        << " resyncs; lateness mean " << meanLateness << " us, max " << maxLateness << " us, jitter " << jitter
+        << " us; spin margin " << spinMargin << " us";
+    return out.str();
+}
+
+Pacer::Pacer(Clock::duration period, int maxBehind): period_(period), maxBehind_(std::max(maxBehind, 1)),
+                                                     spinMargin_(microseconds(200)) {
+    reset();
+}
+
+void Pacer::reset() {
+    deadline_ = Clock::now() + period_;
+    waited_ = 0;
+    latenessSum_ = 0;
+    latenessSquares_ = 0;
+    stats_ = {};
+    stats_.spinMargin = toMicroseconds(spinMargin_);
+}
+
+void Pacer::wait() {
+    ++stats_.frames;
+    Clock::time_point now = Clock::now();
+    if (now >= deadline_) {
+        ++stats_.missed;
+        if (now - deadline_ > maxBehind_ * period_) {
+            ++stats_.resyncs;
+            deadline_ = now;
+        }
+        deadline_ += period_;
+        return;
+    }
+
+    Clock::time_point const wake = deadline_ - spinMargin_;
+    if (now < wake) {
+        std::this_thread::sleep_until(wake);
+        double const overshoot = std::chrono::duration<double, std::nano>(Clock::now() - wake).count();
+        oversleep_ = oversleep_ == 0 ? overshoot : oversleep_ + (overshoot - oversleep_) / 8;
+        auto const margin = std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds((int64_t) (2 * oversleep_)));
+        spinMargin_ = std::clamp<Clock::duration>(margin + minSpinMargin, minSpinMargin, period_ / 4);
+        stats_.spinMargin = toMicroseconds(spinMargin_);
+    }
+    while ((now = Clock::now()) < deadline_) {}
+    record(toMicroseconds(now - deadline_));
+    deadline_ += period_;
+}
+
+void Pacer::record(double lateness) {
+    ++waited_;
+    latenessSum_ += lateness;
+    latenessSquares_ += lateness * lateness;
+    stats_.meanLateness = latenessSum_ / waited_;
+    stats_.maxLateness = std::max(stats_.maxLateness, lateness);
+    stats_.jitter = std::sqrt(std::max(0.0, latenessSquares_ / waited_ - stats_.meanLateness * stats_.meanLateness));
+}
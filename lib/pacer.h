@@ -0,0 +1,58 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_PACER_H
+#define CPU8080_PACER_H
+
+#include <chrono>
+#include <stdint.h>
+#include <string>
+
+struct PacerStats {
+    uint64_t frames {0};
+    uint64_t missed {0};        // Frames whose deadline had passed before wait() was called.
+    uint64_t resyncs {0};       // Times the pacer gave up catching up and restarted its schedule.
+    // How late wait() returned after each deadline it waited for, in microseconds.
+    double meanLateness {0};
+    double maxLateness {0};
+    double jitter {0};          // Standard deviation of the lateness.
+    double spinMargin {0};      // The current spin margin, in microseconds.
+
+    std::string describe() const;
+};
+
+// Paces a run loop to real time, one frame per period: run a frame's worth of cycles, then wait().
+// Deadlines are counted from construction or reset(), so a late wake-up does not push the next
+// frame back and the emulated clock does not drift from the host's.
+//
+// wait() sleeps until a spin margin before the deadline and spins for the rest, since sleeping to
+// the deadline itself overshoots by the scheduler's wake-up latency. The margin follows the
+// oversleep the OS actually shows, so a quiet host spends almost the whole wait asleep.
+class Pacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // maxBehind is how many periods the pacer runs frames back to back to catch up before it
+    // drops them and restarts the schedule from now.
+    explicit Pacer(Clock::duration period, int maxBehind = 5);
+
+    void wait();
+    void reset();
+    PacerStats const& stats() const { return stats_; }
+
+private:
+    void record(double lateness);
+
+    Clock::duration period_;
+    int maxBehind_;
+    Clock::time_point deadline_ {};
+    Clock::duration spinMargin_;
+    double oversleep_ {0};          // Moving average of the sleep overshoot, in nanoseconds.
+    uint64_t waited_ {0};
+    double latenessSum_ {0};
+    double latenessSquares_ {0};
+    PacerStats stats_;
+};
+
+#endif //CPU8080_PACER_H
@@ -0,0 +1,199 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "perfcounters.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <linux/perf_event.h>
+#include <sstream>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint64_t l1dReadMisses = PERF_COUNT_HW_CACHE_L1D | PERF_COUNT_HW_CACHE_OP_READ << 8
+        | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+
+constexpr std::array<std::pair<uint32_t, uint64_t>, hostEventCount> events {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, l1dReadMisses},
+}};
+
+constexpr int calibrationReads = 1000;
+
+int openEvent(uint32_t type, uint64_t config, int group) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof attr);
+    attr.size = sizeof attr;
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+}
+
+void header(std::ostringstream& out, PerfCounters const& counters) {
+    for (size_t i = 0; i < hostEventCount; ++i) {
+        if (counters.available(static_cast<HostEvent>(i))) { out << std::setw(15) << toString(static_cast<HostEvent>(i)); }
+    }
+}
+
+}
+
+char const* toString(HostEvent event) {
+    switch (event) {
+        case HostEvent::CYCLES: return "cycles";
+        case HostEvent::INSTRUCTIONS: return "instructions";
+        case HostEvent::BRANCH_MISSES: return "branch-misses";
+        case HostEvent::L1D_MISSES: return "l1d-misses";
+    }
+    return "?";
+}
+
+PerfCounters::PerfCounters() {
+    for (size_t i = 0; i < hostEventCount; ++i) {
+        fds_[i] = openEvent(events[i].first, events[i].second, leader_);
+        if (leader_ < 0) { leader_ = fds_[i]; }
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd: fds_) {
+        if (fd >= 0) { close(fd); }
+    }
+}
+
+void PerfCounters::start() {
+    if (leader_ < 0) { return; }
+    ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void PerfCounters::stop() {
+    if (leader_ < 0) { return; }
+    ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+}
+
+HostCounts PerfCounters::read() const {
+    HostCounts counts {};
+    if (leader_ < 0) { return counts; }
+    // nr, time enabled, time running, then the values in the order the events joined the group.
+    uint64_t data[3 + hostEventCount];
+    if (::read(leader_, data, sizeof data) < static_cast<ssize_t>(3 * sizeof(uint64_t)) || data[2] == 0) {
+        return counts;
+    }
+    double const scale = data[1] == data[2] ? 1.0 : static_cast<double>(data[1]) / data[2];
+    size_t value = 3;
+    for (size_t i = 0; i < hostEventCount && value < 3 + data[0]; ++i) {
+        if (fds_[i] >= 0) { counts[i] = static_cast<uint64_t>(data[value++] * scale); }
+    }
+    return counts;
+}
+
+OpClass opClass(Byte op) {
+    int const y = (op >> 3) & 7;
+    int const z = op & 7;
+    switch (op >> 6) {
+        case 0:
+            switch (z) {
+                case 1: return y & 1 ? OpClass::PAIR : OpClass::MOVE;
+                case 2: case 6: return OpClass::MOVE;
+                case 3: return OpClass::PAIR;
+                case 4: case 5: case 7: return OpClass::ALU;
+                default: return OpClass::MACHINE;
+            }
+        case 1: return op == 0x76 ? OpClass::MACHINE : OpClass::MOVE;
+        case 2: return OpClass::ALU;
+        default:
+            switch (z) {
+                case 0: case 4: case 7: return OpClass::CALL;
+                case 1:
+                    if (!(y & 1)) { return OpClass::STACK; }
+                    return op == 0xe9 ? OpClass::BRANCH : op == 0xf9 ? OpClass::MOVE : OpClass::CALL;
+                case 2: return OpClass::BRANCH;
+                case 3:
+                    if (op == 0xc3 || op == 0xcb) { return OpClass::BRANCH; }
+                    return op == 0xe3 || op == 0xeb ? OpClass::MOVE : OpClass::MACHINE;
+                case 5: return y & 1 ? OpClass::CALL : OpClass::STACK;
+                default: return OpClass::ALU;
+            }
+    }
+}
+
+char const* toString(OpClass kind) {
+    switch (kind) {
+        case OpClass::MOVE: return "move";
+        case OpClass::ALU: return "alu";
+        case OpClass::PAIR: return "pair";
+        case OpClass::STACK: return "stack";
+        case OpClass::BRANCH: return "branch";
+        case OpClass::CALL: return "call";
+        case OpClass::MACHINE: return "machine";
+    }
+    return "?";
+}
+
+PerfProfiler::PerfProfiler(PerfCounters& counters): counters_(counters) {
+    if (!counters_.anyAvailable()) { return; }
+    counters_.start();
+    for (int i = 0; i < calibrationReads; ++i) {
+        HostCounts const first = counters_.read();
+        HostCounts const second = counters_.read();
+        for (size_t e = 0; e < hostEventCount; ++e) { overhead_[e] += second[e] - first[e]; }
+    }
+    counters_.stop();
+    for (double& cost: overhead_) { cost /= calibrationReads; }
+}
+
+std::string PerfProfiler::report() const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    uint64_t total = 0;
+    for (Totals const& totals: classes_) { total += totals.ops; }
+    if (counters_.anyAvailable()) {
+        out << "host events per op by class, less a read pair of";
+        for (size_t e = 0; e < hostEventCount; ++e) {
+            if (counters_.available(static_cast<HostEvent>(e))) { out << ' ' << overhead_[e] << ' ' << toString(static_cast<HostEvent>(e)); }
+        }
+    } else {
+        out << "ops by class, no hardware counters available";
+    }
+    out << "\n" << std::setw(8) << "class" << std::setw(14) << "ops" << std::setw(9) << "share";
+    header(out, counters_);
+    out << '\n';
+    for (size_t kind = 0; kind < opClassCount; ++kind) {
+        Totals const& totals = classes_[kind];
+        if (totals.ops == 0) { continue; }
+        out << std::setw(8) << toString(static_cast<OpClass>(kind)) << std::setw(14) << totals.ops
+            << std::setw(8) << 100.0 * totals.ops / total << '%';
+        for (size_t e = 0; e < hostEventCount; ++e) {
+            if (!counters_.available(static_cast<HostEvent>(e))) { continue; }
+            double const perOp = static_cast<double>(totals.counts[e]) / totals.ops - overhead_[e];
+            out << std::setw(15) << std::max(perOp, 0.0);
+        }
+        out << '\n';
+    }
+    return out.str();
+}
+
+std::string describeRun(PerfCounters const& counters, HostCounts const& counts, uint64_t ops) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    if (!counters.anyAvailable()) { return "no hardware counters available\n"; }
+    out << "host events per op over " << ops << " ops\n";
+    header(out, counters);
+    out << '\n';
+    for (size_t e = 0; e < hostEventCount; ++e) {
+        if (counters.available(static_cast<HostEvent>(e))) { out << std::setw(15) << (ops ? static_cast<double>(counts[e]) / ops : 0.0); }
+    }
+    out << '\n';
+    return out.str();
+}
@@ -0,0 +1,110 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_PERFCOUNTERS_H
+#define CPU8080_PERFCOUNTERS_H
+
+#include <array>
+#include <string>
+
+#include "emulator.h"
+
+// Host hardware events counted by PerfCounters.
+enum class HostEvent : uint8_t { CYCLES, INSTRUCTIONS, BRANCH_MISSES, L1D_MISSES };
+constexpr size_t hostEventCount = 4;
+
+char const* toString(HostEvent event);
+
+using HostCounts = std::array<uint64_t, hostEventCount>;
+
+// The calling thread's user-space hardware counters, opened as one perf_event_open group so a
+// single read returns them all. Events the kernel or CPU does not offer, as on virtual machines
+// without a PMU, stay closed and read as 0. Linux only.
+class PerfCounters {
+public:
+    PerfCounters();
+    PerfCounters(PerfCounters const&) = delete;
+    PerfCounters& operator=(PerfCounters const&) = delete;
+    ~PerfCounters();
+
+    bool available(HostEvent event) const { return fds_[static_cast<size_t>(event)] >= 0; }
+    bool anyAvailable() const { return leader_ >= 0; }
+    // Zeroes the counters and starts them; stop() freezes them for read().
+    void start();
+    void stop();
+    // Counts since start(), scaled up if the kernel had to multiplex the group.
+    HostCounts read() const;
+
+private:
+    std::array<int, hostEventCount> fds_ {-1, -1, -1, -1};
+    int leader_ {-1};
+};
+
+// The broad kinds of 8080 op, by the interpreter work behind them.
+enum class OpClass : uint8_t {
+    MOVE,       // MOV, MVI, LXI, LDA/STA, LHLD/SHLD, LDAX/STAX, XCHG, XTHL, SPHL.
+    ALU,        // 8-bit arithmetic and logic, INR/DCR, rotates, DAA, CMA, STC, CMC.
+    PAIR,       // INX, DCX, DAD.
+    STACK,      // PUSH, POP.
+    BRANCH,     // JMP, Jcc, PCHL.
+    CALL,       // CALL, Ccc, RET, Rcc, RST.
+    MACHINE,    // IN, OUT, EI, DI, HLT, NOP and the undocumented opcodes.
+};
+constexpr size_t opClassCount = 7;
+
+OpClass opClass(Byte op);
+char const* toString(OpClass kind);
+
+// Run hook that reads the counters around every op and charges the difference to its class. Each
+// read is a system call; the user-space cost of a back-to-back pair of them, measured when
+// constructed, is subtracted in the report. The calls still disturb the caches and branch
+// predictors, so compare classes with each other and totals with PerfCounters around a plain run.
+class PerfProfiler {
+public:
+    explicit PerfProfiler(PerfCounters& counters);
+
+    void beforeOp(Status const& status) {
+        op_ = status.memory[status.pc];
+        before_ = counters_.read();
+    }
+
+    void afterOp(Status const&) {
+        HostCounts const after = counters_.read();
+        Totals& totals = classes_[static_cast<size_t>(opClass(op_))];
+        ++totals.ops;
+        for (size_t i = 0; i < hostEventCount; ++i) { totals.counts[i] += after[i] - before_[i]; }
+    }
+
+    uint64_t ops(OpClass kind) const { return classes_[static_cast<size_t>(kind)].ops; }
+    HostCounts const& counts(OpClass kind) const { return classes_[static_cast<size_t>(kind)].counts; }
+    // The measured cost of one read pair, per event.
+    std::array<double, hostEventCount> const& overhead() const { return overhead_; }
+
+    // Per class: ops, their share, and each available event per op less the read overhead.
+    std::string report() const;
+
+private:
+    struct Totals {
+        uint64_t ops {0};
+        HostCounts counts {};
+    };
+
+    PerfCounters& counters_;
+    std::array<Totals, opClassCount> classes_ {};
+    std::array<double, hostEventCount> overhead_ {};
+    HostCounts before_ {};
+    Byte op_ {0};
+};
+
+// Run hook that only counts ops, to divide whole-run counts by.
+struct OpCounter {
+    uint64_t ops {0};
+    void beforeOp(Status const&) {}
+    void afterOp(Status const&) { ++ops; }
+};
+
+// Host events per emulated op for a run, from the counters around it.
+std::string describeRun(PerfCounters const& counters, HostCounts const& counts, uint64_t ops);
+
+#endif //CPU8080_PERFCOUNTERS_H
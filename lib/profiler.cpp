@@ -0,0 +1,91 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <string_view>
+
+#include "disassembler.h"
+
+namespace {
+
+template <typename Counts, typename Weight>
+std::vector<size_t> hottest(Counts const& counts, Weight weight, size_t top) {
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (weight(counts[i])) { indices.push_back(i); }
+    }
+    auto const middle = indices.begin() + std::min(top, indices.size());
+    std::partial_sort(indices.begin(), middle, indices.end(), [&](size_t a, size_t b) {
+        return weight(counts[a]) > weight(counts[b]);
+    });
+    indices.erase(middle, indices.end());
+    return indices;
+}
+
+// The opcode's text without its operand placeholders.
+std::string_view mnemonic(size_t op) {
+    std::string_view name(opcodes[op].text, opcodes[op].textLength);
+    while (!name.empty() && std::string_view("#$, ").find(name.back()) != std::string_view::npos) {
+        name.remove_suffix(1);
+    }
+    return name;
+}
+
+}
+
+std::string Profiler::report(std::span<Byte const> memory, size_t top) const {
+    Disassembler disassembler;
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+
+    uint64_t const total = std::accumulate(opHits_.begin(), opHits_.end(), uint64_t {0});
+    auto share = [&](uint64_t n) { return total ? 100.0 * n / total : 0.0; };
+    auto identity = [](uint64_t n) { return n; };
+
+    out << "hottest PCs (" << total << " ops)\n";
+    for (size_t pc: hottest(pcHits_, identity, top)) {
+        char line[Disassembler::maxLineLength];
+        char* cursor = line;
+        disassembler.disassembleOp(pc, memory, cursor);
+        out << std::setw(12) << pcHits_[pc] << std::setw(8) << share(pcHits_[pc]) << "%  ";
+        out.write(line, cursor - line);
+    }
+
+    out << "\nhottest opcodes\n";
+    for (size_t op: hottest(opHits_, identity, top)) {
+        out << std::setw(12) << opHits_[op] << std::setw(8) << share(opHits_[op]) << "%  "
+            << std::hex << std::setw(2) << std::setfill('0') << op << std::dec << std::setfill(' ')
+            << '\t' << mnemonic(op) << '\n';
+    }
+
+    // The input superinstructions.py picks fused pairs from.
+    out << "\nhottest opcode pairs\n";
+    for (size_t pair: hottest(pairHits_, identity, top)) {
+        out << std::setw(12) << pairHits_[pair] << std::setw(8) << share(pairHits_[pair]) << "%  "
+            << std::hex << std::setfill('0') << std::setw(2) << (pair >> 8) << ' ' << std::setw(2) << (pair & 0xff)
+            << std::dec << std::setfill(' ') << '\t' << mnemonic(pair >> 8) << "; " << mnemonic(pair & 0xff) << '\n';
+    }
+
+    out << "\ncall targets by inclusive cycles\n";
+    for (size_t target: hottest(calls_, [](CallStats const& s) { return s.cycles; }, top)) {
+        CallStats const& stats = calls_[target];
+        out << std::setw(12) << stats.cycles << " cycles" << std::setw(10) << stats.calls << " calls  $"
+            << std::hex << std::setw(4) << std::setfill('0') << target << std::dec << std::setfill(' ') << '\n';
+    }
+    return out.str();
+}
+
+void Profiler::reset() {
+    std::fill(pcHits_.begin(), pcHits_.end(), 0);
+    opHits_.fill(0);
+    std::fill(pairHits_.begin(), pairHits_.end(), 0);
+    next_ = 1 << 16;
+    std::fill(calls_.begin(), calls_.end(), CallStats {});
+    frames_.clear();
+}
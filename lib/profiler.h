@@ -0,0 +1,89 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_PROFILER_H
+#define CPU8080_PROFILER_H
+
+#include <array>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "emulator.h"
+#include "opcodes.h"
+
+struct CallStats {
+    uint64_t calls {0};
+    uint64_t cycles {0};    // Inclusive of nested calls and of the CALL/RET themselves.
+};
+
+// Counts executions per PC, per opcode and per pair of opcodes run one after the other in memory,
+// and the cycles spent below every CALL/RST target. Pass it to Emulator::run; the default
+// NullProfiler keeps the loop free of any bookkeeping.
+class Profiler {
+public:
+    Profiler(): pcHits_(1 << 16, 0), pairHits_(1 << 16, 0), calls_(1 << 16) {}
+
+    void beforeOp(Status const& status) {
+        if (status.pc == next_) { ++pairHits_[op_ << 8 | status.memory[status.pc]]; }
+        pc_ = status.pc;
+        sp_ = status.sp;
+        cycles_ = status.cycles;
+        op_ = status.memory[status.pc];
+    }
+
+    void afterOp(Status const& status) {
+        ++pcHits_[pc_];
+        ++opHits_[op_];
+        next_ = static_cast<uint16_t>(pc_ + opcodes[op_].length);
+        FlowKind const flow = opcodes[op_].flow;
+        if (flow == FLOW_NONE) { return; }
+        if ((flow == FLOW_CALL || flow == FLOW_COND_CALL || flow == FLOW_RST) && status.sp == (uint16_t) (sp_ - 2)) {
+            frames_.push_back({status.pc, sp_, cycles_});
+        } else if ((flow == FLOW_RET || flow == FLOW_COND_RET) && status.sp == (uint16_t) (sp_ + 2)) {
+            leaveFrames(status);
+        }
+    }
+
+    uint64_t hits(uint16_t pc) const { return pcHits_[pc]; }
+    uint64_t opcodeHits(Byte op) const { return opHits_[op]; }
+    // How often second ran straight after first, from the bytes following it.
+    uint64_t pairHits(Byte first, Byte second) const { return pairHits_[first << 8 | second]; }
+    CallStats const& callStats(uint16_t target) const { return calls_[target]; }
+
+    // Hottest PCs with their disassembly from memory, then per-opcode counts and call targets by cycles.
+    std::string report(std::span<Byte const> memory, size_t top = 20) const;
+    void reset();
+
+private:
+    struct Frame {
+        uint16_t target;
+        uint16_t sp;        // SP before the return address was pushed.
+        uint64_t cycles;    // Cycle count before the CALL.
+    };
+
+    // Closes every frame the return unwound, which also copes with code that discards return addresses.
+    void leaveFrames(Status const& status) {
+        while (!frames_.empty() && frames_.back().sp <= status.sp) {
+            auto& stats = calls_[frames_.back().target];
+            ++stats.calls;
+            stats.cycles += status.cycles - frames_.back().cycles;
+            frames_.pop_back();
+        }
+    }
+
+    std::vector<uint64_t> pcHits_;
+    std::array<uint64_t, 256> opHits_ {};
+    std::vector<uint64_t> pairHits_;
+    std::vector<CallStats> calls_;
+    std::vector<Frame> frames_;
+
+    uint16_t pc_ {0};
+    uint16_t sp_ {0};
+    uint64_t cycles_ {0};
+    uint32_t next_ {1 << 16};   // Where the op after op_ starts; never a PC before the first op.
+    Byte op_ {0};
+};
+
+#endif //CPU8080_PROFILER_H
@@ -0,0 +1,130 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "rom.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::string describe(std::string const& filename, char const* what) {
+    return filename + ": " + what;
+}
+
+}
+
+#ifdef _WIN32
+
+MappedRom::MappedRom(std::string const& filename): filename_{filename} {
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) { throw RomLoadError(describe(filename, "cannot open file")); }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0 || fileSize.QuadPart > (LONGLONG) addressSpaceSize) {
+        CloseHandle(file);
+        throw RomLoadError(describe(filename, "size must be between 1 byte and 64 KiB"));
+    }
+    size_ = fileSize.QuadPart;
+
+    mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping_) { throw RomLoadError(describe(filename, "cannot map file")); }
+    data_ = static_cast<Byte const*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (!data_) {
+        CloseHandle(mapping_);
+        throw RomLoadError(describe(filename, "cannot map file"));
+    }
+}
+
+MappedRom::~MappedRom() {
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_);
+}
+
+#else
+
+MappedRom::MappedRom(std::string const& filename): filename_{filename} {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) { throw RomLoadError(describe(filename, strerror(errno))); }
+
+    struct stat st {};
+    if (fstat(fd, &st) != 0) {
+        int err = errno;
+        close(fd);
+        throw RomLoadError(describe(filename, strerror(err)));
+    }
+    if (st.st_size == 0 || st.st_size > (off_t) addressSpaceSize) {
+        close(fd);
+        throw RomLoadError(describe(filename, "size must be between 1 byte and 64 KiB"));
+    }
+    size_ = st.st_size;
+
+    void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    int err = errno;
+    close(fd);
+    if (data == MAP_FAILED) { throw RomLoadError(describe(filename, strerror(err))); }
+    data_ = static_cast<Byte const*>(data);
+}
+
+MappedRom::~MappedRom() {
+    munmap(const_cast<Byte*>(data_), size_);
+}
+
+#endif
+
+std::shared_ptr<MappedRom const> mapRom(std::string const& filename) {
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<MappedRom const>> mapped;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = mapped[filename];
+    if (auto rom = entry.lock()) { return rom; }
+    auto rom = std::make_shared<MappedRom const>(filename);
+    entry = rom;
+    return rom;
+}
+
+std::vector<RomPart> spaceInvadersParts(std::string const& directory) {
+    std::string const prefix = directory.empty() ? "" : directory + "/";
+    return {
+        {prefix + "invaders.h", 0x0000},
+        {prefix + "invaders.g", 0x0800},
+        {prefix + "invaders.f", 0x1000},
+        {prefix + "invaders.e", 0x1800},
+    };
+}
+
+void loadRom(std::vector<RomPart> const& parts, std::span<Byte> memory) {
+    std::vector<std::pair<size_t, size_t>> loaded;
+    for (auto const& part: parts) {
+        auto const rom = mapRom(part.filename);
+        auto const bytes = rom->bytes();
+        size_t const begin = part.offset;
+        size_t const end = begin + bytes.size();
+        if (end > memory.size()) {
+            throw RomLoadError(describe(part.filename, "does not fit in the address space at its offset"));
+        }
+        for (auto const& [otherBegin, otherEnd]: loaded) {
+            if (begin < otherEnd && otherBegin < end) {
+                throw RomLoadError(describe(part.filename, "overlaps a previously loaded part"));
+            }
+        }
+        loaded.emplace_back(begin, end);
+        std::copy(bytes.begin(), bytes.end(), memory.begin() + begin);
+    }
+}
@@ -0,0 +1,58 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_ROM_H
+#define CPU8080_ROM_H
+
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+constexpr size_t addressSpaceSize = 1 << 16;
+
+class RomLoadError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Read-only memory mapping of a ROM file.
+class MappedRom {
+public:
+    explicit MappedRom(std::string const& filename);
+    ~MappedRom();
+    MappedRom(MappedRom const&) = delete;
+    MappedRom& operator=(MappedRom const&) = delete;
+
+    std::span<Byte const> bytes() const { return {data_, size_}; }
+    std::string const& filename() const { return filename_; }
+
+private:
+    std::string filename_;
+    Byte const* data_ {nullptr};
+    size_t size_ {0};
+#ifdef _WIN32
+    void* mapping_ {nullptr};
+#endif
+};
+
+// Maps filename once per process; every caller holding the result shares the same pages.
+std::shared_ptr<MappedRom const> mapRom(std::string const& filename);
+
+struct RomPart {
+    std::string filename;
+    uint16_t offset {0};
+};
+
+// The four 2 KiB parts of the Space Invaders ROM (invaders.h, .g, .f, .e) found in directory.
+std::vector<RomPart> spaceInvadersParts(std::string const& directory);
+
+// Copies every part into memory at its offset. Throws RomLoadError when a file cannot be mapped,
+// a part does not fit in the 64 KiB address space or two parts overlap.
+void loadRom(std::vector<RomPart> const& parts, std::span<Byte> memory);
+
+#endif //CPU8080_ROM_H
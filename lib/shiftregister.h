@@ -0,0 +1,29 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_SHIFTREGISTER_H
+#define CPU8080_SHIFTREGISTER_H
+
+#include <stdint.h>
+
+#include "types.h"
+
+// The Midway 8080 board's external barrel shifter, which Space Invaders uses for every sprite it
+// draws at a pixel offset: OUT 4 shifts a byte into the top of a 16-bit register, OUT 2 sets a
+// 3-bit offset and IN 3 reads the 8 bits that many bits below the top. Emulator handles these
+// three ports itself when one is set, so a blit pays a compare per IN or OUT, not a virtual call.
+struct ShiftRegister {
+    static constexpr Byte offsetPort = 2;
+    static constexpr Byte resultPort = 3;
+    static constexpr Byte dataPort = 4;
+
+    void shiftIn(Byte data) { value = data << 8 | value >> 8; }
+    void setOffset(Byte data) { offset = data & 7; }
+    Byte result() const { return value >> (8 - offset); }
+
+    uint16_t value {0};
+    Byte offset {0};
+};
+
+#endif //CPU8080_SHIFTREGISTER_H
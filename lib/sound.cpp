@@ -0,0 +1,227 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "sound.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+uint32_t little(std::string const& bytes, size_t pos, int size) {
+    uint32_t value = 0;
+    for (int i = 0; i < size; ++i) { value |= uint32_t {(Byte) bytes[pos + i]} << (8 * i); }
+    return value;
+}
+
+void putLittle(std::string& out, uint32_t value, int size) {
+    for (int i = 0; i < size; ++i) { out += static_cast<char>(value >> (8 * i)); }
+}
+
+}
+
+std::vector<int16_t> loadWav(std::string const& filename, unsigned sampleRate) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) { throw AudioError(filename + ": cannot open file"); }
+    std::string const bytes {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    if (bytes.size() < 12 || bytes.compare(0, 4, "RIFF") != 0 || bytes.compare(8, 4, "WAVE") != 0) {
+        throw AudioError(filename + ": not a WAV file");
+    }
+
+    unsigned channels = 0;
+    unsigned rate = 0;
+    unsigned bits = 0;
+    size_t dataPos = 0;
+    size_t dataSize = 0;
+    for (size_t pos = 12; pos + 8 <= bytes.size();) {
+        uint32_t const size = little(bytes, pos + 4, 4);
+        size_t const body = pos + 8;
+        if (size > bytes.size() - body) { throw AudioError(filename + ": truncated"); }
+        if (bytes.compare(pos, 4, "fmt ") == 0 && size >= 16) {
+            if (little(bytes, body, 2) != 1) { throw AudioError(filename + ": not PCM"); }
+            channels = little(bytes, body + 2, 2);
+            rate = little(bytes, body + 4, 4);
+            bits = little(bytes, body + 14, 2);
+        } else if (bytes.compare(pos, 4, "data") == 0) {
+            dataPos = body;
+            dataSize = size;
+        }
+        pos = body + size + (size & 1);
+    }
+    if (channels == 0 || rate == 0 || (bits != 8 && bits != 16) || dataPos == 0) {
+        throw AudioError(filename + ": need 8- or 16-bit PCM with a data chunk");
+    }
+
+    size_t const frameSize = channels * bits / 8;
+    std::vector<int16_t> mono(dataSize / frameSize);
+    for (size_t i = 0; i < mono.size(); ++i) {
+        int32_t sum = 0;
+        for (unsigned c = 0; c < channels; ++c) {
+            size_t const pos = dataPos + i * frameSize + c * bits / 8;
+            sum += bits == 8 ? ((int32_t) (Byte) bytes[pos] - 128) << 8 : (int16_t) little(bytes, pos, 2);
+        }
+        mono[i] = sum / (int32_t) channels;
+    }
+    if (rate == sampleRate || mono.empty()) { return mono; }
+
+    std::vector<int16_t> resampled((uint64_t) mono.size() * sampleRate / rate);
+    for (size_t i = 0; i < resampled.size(); ++i) {
+        double const source = (double) i * rate / sampleRate;
+        size_t const at = std::min((size_t) source, mono.size() - 1);
+        size_t const next = std::min(at + 1, mono.size() - 1);
+        double const fraction = source - at;
+        resampled[i] = (int16_t) (mono[at] + (mono[next] - mono[at]) * fraction);
+    }
+    return resampled;
+}
+
+void writeWav(std::string const& filename, std::span<int16_t const> samples, unsigned sampleRate) {
+    uint32_t const dataSize = samples.size() * 2;
+    std::string out = "RIFF";
+    putLittle(out, 36 + dataSize, 4);
+    out += "WAVEfmt ";
+    putLittle(out, 16, 4);
+    putLittle(out, 1, 2);               // PCM
+    putLittle(out, 1, 2);               // Mono
+    putLittle(out, sampleRate, 4);
+    putLittle(out, sampleRate * 2, 4);  // Bytes per second
+    putLittle(out, 2, 2);               // Bytes per frame
+    putLittle(out, 16, 2);
+    out += "data";
+    putLittle(out, dataSize, 4);
+    for (int16_t sample: samples) { putLittle(out, (uint16_t) sample, 2); }
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    file.write(out.data(), out.size());
+    if (!file) { throw AudioError(filename + ": cannot write file"); }
+}
+
+Mixer::Mixer(Samples samples, unsigned sampleRate, uint64_t clockHz): samples_(std::move(samples)),
+                                                                     sampleRate_(sampleRate), clockHz_(clockHz) {}
+
+void Mixer::apply(SoundEvent const& event, std::vector<int16_t>& out) {
+    render(event.cycles, out);
+    if (event.port == 3) {
+        Byte const rising = event.value & ~port3_;
+        for (int bit = 0; bit < 4; ++bit) {
+            if (rising & (1 << bit)) { voices_[bit] = {0, true}; }
+        }
+        if (!(event.value & 0x01)) { voices_[0].playing = false; }
+        port3_ = event.value;
+    } else if (event.port == 5) {
+        Byte const rising = event.value & ~port5_;
+        for (int bit = 0; bit < 5; ++bit) {
+            if (rising & (1 << bit)) { voices_[4 + bit] = {0, true}; }
+        }
+        port5_ = event.value;
+    }
+}
+
+void Mixer::render(uint64_t cycles, std::vector<int16_t>& out) {
+    uint64_t const end = cycles * sampleRate_ / clockHz_;
+    for (; rendered_ < end; ++rendered_) {
+        int32_t sum = 0;
+        for (int sound = 0; sound < soundCount; ++sound) {
+            Voice& voice = voices_[sound];
+            auto const& sample = samples_[sound];
+            if (!voice.playing) { continue; }
+            if (voice.position >= sample.size()) {
+                // Only the UFO loops; the others are done.
+                if (sound != 0 || sample.empty()) {
+                    voice.playing = false;
+                    continue;
+                }
+                voice.position = 0;
+            }
+            sum += sample[voice.position++];
+        }
+        out.push_back((int16_t) std::clamp<int32_t>(sum, INT16_MIN, INT16_MAX));
+    }
+}
+
+SoundBoard::SoundBoard(Mixer::Samples samples, unsigned sampleRate, uint64_t clockHz):
+        mixer_(std::move(samples), sampleRate, clockHz), sampleRate_(sampleRate), events_(4096), output_(sampleRate) {}
+
+SoundBoard::~SoundBoard() {
+    stop();
+}
+
+Mixer::Samples SoundBoard::loadSamples(std::string const& directory, unsigned sampleRate) {
+    Mixer::Samples samples;
+    for (int sound = 0; sound < Mixer::soundCount; ++sound) {
+        std::string const filename = (std::filesystem::path(directory) / (std::to_string(sound) + ".wav")).string();
+        if (std::filesystem::exists(filename)) { samples[sound] = loadWav(filename, sampleRate); }
+    }
+    return samples;
+}
+
+void SoundBoard::write(Byte port, Byte value, uint64_t cycles) {
+    Byte& last = port == 3 ? port3_ : port5_;
+    if ((port != 3 && port != 5) || value == last) { return; }
+    last = value;
+    push({cycles, port, value});
+}
+
+void SoundBoard::advance(uint64_t cycles) {
+    if (running_.load(std::memory_order_relaxed)) {
+        push({cycles, tick, 0});
+        return;
+    }
+    drain(offline_);
+    mixer_.render(cycles, offline_);
+}
+
+void SoundBoard::push(SoundEvent const& event) {
+    if (!events_.push(event)) { ++droppedEvents_; }
+}
+
+void SoundBoard::drain(std::vector<int16_t>& out) {
+    SoundEvent event {};
+    while (events_.pop(event)) {
+        if (event.port == tick) {
+            mixer_.render(event.cycles, out);
+        } else {
+            mixer_.apply(event, out);
+        }
+    }
+}
+
+void SoundBoard::start() {
+    if (thread_.joinable()) { return; }
+    running_ = true;
+    thread_ = std::thread(&SoundBoard::mixLoop, this);
+}
+
+void SoundBoard::stop() {
+    if (!thread_.joinable()) { return; }
+    running_ = false;
+    thread_.join();
+}
+
+void SoundBoard::mixLoop() {
+    std::vector<int16_t> block;
+    while (true) {
+        bool const running = running_.load();
+        drain(block);
+        for (int16_t sample: block) {
+            if (!output_.push(sample)) { droppedSamples_.fetch_add(1, std::memory_order_relaxed); }
+        }
+        if (!running) { return; }
+        if (block.empty()) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+        block.clear();
+    }
+}
+
+size_t SoundBoard::read(std::span<int16_t> out) {
+    size_t count = 0;
+    while (count < out.size() && output_.pop(out[count])) { ++count; }
+    return count;
+}
+
+void SoundBoard::writeWav(std::string const& filename) const {
+    ::writeWav(filename, offline_, sampleRate_);
+}
@@ -0,0 +1,122 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_SOUND_H
+#define CPU8080_SOUND_H
+
+#include <array>
+#include <atomic>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spsc.h"
+#include "types.h"
+
+class AudioError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// 16-bit PCM WAV files. loadWav takes 8- or 16-bit PCM in any channel count, mixes it down to mono
+// and resamples it to sampleRate. Both throw AudioError.
+std::vector<int16_t> loadWav(std::string const& filename, unsigned sampleRate);
+void writeWav(std::string const& filename, std::span<int16_t const> samples, unsigned sampleRate);
+
+// A write to one of the sound ports, stamped with the cycle count of the OUT.
+struct SoundEvent {
+    uint64_t cycles;
+    Byte port;
+    Byte value;
+};
+
+// Turns sound port writes into mono samples: every bit that goes from 0 to 1 starts its sample
+// from the beginning, except the UFO, which loops for as long as its bit stays set. Sample n of
+// the output belongs to cycle n * clockHz / sampleRate, so the result depends only on the events.
+class Mixer {
+public:
+    // Port 3 bits 0-3 are the UFO, shot, player and invader explosions; port 5 bits 0-4 the four
+    // fleet movement steps and the UFO hit. Conventionally 0.wav to 8.wav.
+    static constexpr int soundCount = 9;
+    using Samples = std::array<std::vector<int16_t>, soundCount>;
+
+    Mixer(Samples samples, unsigned sampleRate, uint64_t clockHz);
+
+    // Appends the samples up to cycles to out, then applies event. Events come in cycle order.
+    void apply(SoundEvent const& event, std::vector<int16_t>& out);
+    void render(uint64_t cycles, std::vector<int16_t>& out);
+
+private:
+    struct Voice {
+        size_t position {0};
+        bool playing {false};
+    };
+
+    Samples samples_;
+    unsigned sampleRate_;
+    uint64_t clockHz_;
+    uint64_t rendered_ {0};     // Samples produced so far.
+    Byte port3_ {0};
+    Byte port5_ {0};
+    std::array<Voice, soundCount> voices_ {};
+};
+
+// The Space Invaders sound board on ports 3 and 5. write() and advance() run on the emulation
+// thread and only ever push onto a lock-free queue, so emulation never waits for the mixer.
+//
+// Started, a mixer thread turns the queue into samples in a second lock-free queue, which an
+// audio callback drains with read(). Not started, the board is offline: advance() mixes on the
+// calling thread into a buffer that writeWav() saves, which needs no audio hardware and gives
+// the same samples.
+class SoundBoard {
+public:
+    SoundBoard(Mixer::Samples samples, unsigned sampleRate, uint64_t clockHz);
+    ~SoundBoard();
+    SoundBoard(SoundBoard const&) = delete;
+    SoundBoard& operator=(SoundBoard const&) = delete;
+
+    // 0.wav to 8.wav from directory; missing files are silent.
+    static Mixer::Samples loadSamples(std::string const& directory, unsigned sampleRate);
+
+    void write(Byte port, Byte value, uint64_t cycles);
+    // Emulated time has reached cycles; the mixer may render up to it.
+    void advance(uint64_t cycles);
+
+    void start();
+    // Mixes what is queued and joins the mixer thread.
+    void stop();
+    // Takes up to out.size() mixed samples; the audio callback side of a started board.
+    size_t read(std::span<int16_t> out);
+
+    // The samples mixed offline so far.
+    std::vector<int16_t> const& offline() const { return offline_; }
+    void writeWav(std::string const& filename) const;
+
+    // Events lost to a full queue and samples lost because nobody read them.
+    uint64_t droppedEvents() const { return droppedEvents_; }
+    uint64_t droppedSamples() const { return droppedSamples_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr Byte tick = 0xff;  // Port of the events advance() queues.
+
+    void push(SoundEvent const& event);
+    void drain(std::vector<int16_t>& out);
+    void mixLoop();
+
+    Mixer mixer_;
+    unsigned sampleRate_;
+    SpscQueue<SoundEvent> events_;
+    SpscQueue<int16_t> output_;
+    Byte port3_ {0};
+    Byte port5_ {0};
+    uint64_t droppedEvents_ {0};
+    std::atomic<uint64_t> droppedSamples_ {0};
+    std::vector<int16_t> offline_;
+    std::atomic<bool> running_ {false};
+    std::thread thread_;
+};
+
+#endif //CPU8080_SOUND_H
@@ -0,0 +1,60 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_SPSC_H
+#define CPU8080_SPSC_H
+
+#include <atomic>
+#include <bit>
+#include <stddef.h>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread. Neither side
+// ever waits: push fails when the queue is full and pop when it is empty. Each side keeps a copy
+// of the other's index and only reloads it when the copy says full or empty, so in the steady
+// state the two threads do not share a cache line.
+template <typename T>
+class SpscQueue {
+public:
+    // Holds at least capacity items; the size is rounded up to a power of two.
+    explicit SpscQueue(size_t capacity): slots_(std::bit_ceil(capacity < 2 ? 2 : capacity)), mask_(slots_.size() - 1) {}
+    SpscQueue(SpscQueue const&) = delete;
+    SpscQueue& operator=(SpscQueue const&) = delete;
+
+    bool push(T const& value) {
+        size_t const tail = tail_.load(std::memory_order_relaxed);
+        if (tail - headCache_ == slots_.size()) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (tail - headCache_ == slots_.size()) { return false; }
+        }
+        slots_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& value) {
+        size_t const head = head_.load(std::memory_order_relaxed);
+        if (head == tailCache_) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (head == tailCache_) { return false; }
+        }
+        value = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return slots_.size(); }
+    // Only exact while neither side is running.
+    size_t size() const { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+
+private:
+    std::vector<T> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> head_ {0};  // Written by the consumer.
+    size_t tailCache_ {0};
+    alignas(64) std::atomic<size_t> tail_ {0};  // Written by the producer.
+    size_t headCache_ {0};
+};
+
+#endif //CPU8080_SPSC_H
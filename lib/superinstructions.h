@@ -0,0 +1,244 @@
+//
+// Generated by lib/superinstructions.py from workloads.txt; do not edit.
+//
+
+#ifndef CPU8080_SUPERINSTRUCTIONS_H
+#define CPU8080_SUPERINSTRUCTIONS_H
+
+#include <array>
+#include <stdint.h>
+#include <utility>
+
+#include "emulator.h"
+#include "opcodes.h"
+
+// Fused handlers for the hottest opcode pairs of a profile: Emulator::run runs each pair in one
+// dispatch, with the state the two ops would have left one after the other.
+namespace superinstructions {
+
+// The pairs, hottest first, as first << 8 | second.
+inline constexpr std::array<uint16_t, 16> pairs {
+    0x0dc2,  // DCR C; JNZ
+    0x1323,  // INX D; INX H
+    0x7713,  // MOV M,A; INX D
+    0x1a8e,  // LDAX D; ADC M
+    0x230d,  // INX H; DCR C
+    0x0b78,  // DCX B; MOV A,B
+    0x78b1,  // MOV A,B; ORA C
+    0xb1c2,  // ORA C; JNZ
+    0x47e6,  // MOV B,A; ANI
+    0x78da,  // MOV A,B; JC
+    0x7ec6,  // MOV A,M; ADI
+    0xc647,  // ADI; MOV B,A
+    0xe6fe,  // ANI; CPI
+    0xfe78,  // CPI; MOV A,B
+    0x1121,  // LXI D; LXI H
+    0x0eaf,  // MVI C; XRA A
+};
+
+// Whether a pair starts with the opcode.
+inline constexpr std::array<bool, 256> starts = [] {
+    std::array<bool, 256> table {};
+    for (uint16_t fused: pairs) { table[fused >> 8] = true; }
+    return table;
+}();
+
+// Bit first << 8 | second is set for the pairs.
+inline constexpr std::array<uint64_t, (1 << 16) / 64> bits = [] {
+    std::array<uint64_t, (1 << 16) / 64> table {};
+    for (uint16_t fused: pairs) { table[fused >> 6] |= uint64_t {1} << (fused & 63); }
+    return table;
+}();
+
+inline bool fuses(Byte first, Byte second) {
+    uint16_t const key = first << 8 | second;
+    return (bits[key >> 6] >> (key & 63)) & 1;
+}
+
+inline uint16_t word(Byte const* m, int at) {
+    return m[static_cast<uint16_t>(at)] | m[static_cast<uint16_t>(at + 1)] << 8;
+}
+
+// Runs the pair of first, at pc, and second, at next. False, changing nothing, when first
+// would write into the second op.
+inline bool run(Emulator& e, uint16_t pc, Byte first, uint16_t next, Byte second) {
+    Status& s = e.status_;
+    Byte* m = s.memory.data();
+    switch (first) {
+        case 0x0b:
+            switch (second) {
+                case 0x78: { // DCX B; MOV A,B
+                    e.dcx(s.bc);
+                    s.a = s.b;
+                    s.pc = next + opcodes[0x78].length;
+                    s.cycles += opcodes[0x0b].cycles + opcodes[0x78].cycles;
+                    return true;
+                }
+            }
+            return false;
+        case 0x0d:
+            switch (second) {
+                case 0xc2: { // DCR C; JNZ
+                    e.dcr(s.c);
+                    s.pc = !s.controls.z ? word(m, next + 1) : static_cast<uint16_t>(next + 3);
+                    s.cycles += opcodes[0x0d].cycles + opcodes[0xc2].cycles;
+                    return true;
+                }
+            }
+            return false;
+        case 0x0e:
+            switch (second) {
+                case 0xaf: { // MVI C; XRA A
+                    s.c = m[static_cast<uint16_t>(pc + 1)];
+                    e.xra(s.a);
+                    s.pc = next + opcodes[0xaf].length;
+                    s.cycles += opcodes[0x0e].cycles + opcodes[0xaf].cycles;
+                    return true;
+                }
+            }
+            return false;
+        case 0x11:
+            switch (second) {
+                case 0x21: { // LXI D; LXI H
+                    s.de = word(m, pc + 1);
+                    s.hl = word(m, next + 1);
+                    s.pc = next + opcodes[0x21].length;
+                    s.cycles += opcodes[0x11].cycles + opcodes[0x21].cycles;
+                    return true;
+                }
+            }
+            return false;
+        case 0x13:
+            switch (second) {
+                case 0x23: { // INX D; INX H
+                    e.inx(s.de);
+                    e.inx(s.hl);
+                    s.pc = next + opcodes[0x23].length;
+                    s.cycles += opcodes[0x13].cycles + opcodes[0x23].cycles;
+                    return true;
+                }
+            }
+            return false;
+        case 0x1a:
+            switch (second) {
+                case 0x8e: { // LDAX D; ADC M
+                    e.ldax(s.de);
+                    e.adc(s.a, m[s.hl]);
+                    s.pc = next + opcodes[0x8e].length;
+                    s.cycles += opcodes[0x1a].cycles + opcodes[0x8e].cycles;
+                    return true;
+                }
+            }
+            return false;
+        case 0x23:
+            switch (second) {
+                case 0x0d: { // INX H; DCR C
+                    e.inx(s.hl);
+                    e.dcr(s.c);
+                    s.pc = next + opcodes[0x0d].length;
+                    s.cycles += opcodes[0x23].cycles + opcodes[0x0d].cycles;
+                    return true;
+                }
+            }
+            return false;
+        case 0x47:
+            switch (second) {
+                case 0xe6: { // MOV B,A; ANI
+                    s.b = s.a;
+                    e.ana(m[static_cast<uint16_t>(next + 1)]);
+                    s.pc = next + opcodes[0xe6].length;
+                    s.cycles += opcodes[0x47].cycles + opcodes[0xe6].cycles;
+                    return true;
+                }
+            }
+            return false;
+        case 0x77:
+            switch (second) {
+                case 0x13: { // MOV M,A; INX D
+                    if (static_cast<uint16_t>(s.hl - next) < opcodes[0x13].length) { return false; }
+                    m[s.hl] = s.a;
+                    e.inx(s.de);
+                    s.pc = next + opcodes[0x13].length;
+                    s.cycles += opcodes[0x77].cycles + opcodes[0x13].cycles;
+                    return true;
+                }
+            }
+            return false;
+        case 0x78:
+            switch (second) {
+                case 0xb1: { // MOV A,B; ORA C
+                    s.a = s.b;
+                    e.ora(s.c);
+                    s.pc = next + opcodes[0xb1].length;
+                    s.cycles += opcodes[0x78].cycles + opcodes[0xb1].cycles;
+                    return true;
+                }
+                case 0xda: { // MOV A,B; JC
+                    s.a = s.b;
+                    s.pc = s.controls.c ? word(m, next + 1) : static_cast<uint16_t>(next + 3);
+                    s.cycles += opcodes[0x78].cycles + opcodes[0xda].cycles;
+                    return true;
+                }
+            }
+            return false;
+        case 0x7e:
+            switch (second) {
+                case 0xc6: { // MOV A,M; ADI
+                    s.a = m[s.hl];
+                    e.add(s.a, m[static_cast<uint16_t>(next + 1)]);
+                    s.pc = next + opcodes[0xc6].length;
+                    s.cycles += opcodes[0x7e].cycles + opcodes[0xc6].cycles;
+                    return true;
+                }
+            }
+            return false;
+        case 0xb1:
+            switch (second) {
+                case 0xc2: { // ORA C; JNZ
+                    e.ora(s.c);
+                    s.pc = !s.controls.z ? word(m, next + 1) : static_cast<uint16_t>(next + 3);
+                    s.cycles += opcodes[0xb1].cycles + opcodes[0xc2].cycles;
+                    return true;
+                }
+            }
+            return false;
+        case 0xc6:
+            switch (second) {
+                case 0x47: { // ADI; MOV B,A
+                    e.add(s.a, m[static_cast<uint16_t>(pc + 1)]);
+                    s.b = s.a;
+                    s.pc = next + opcodes[0x47].length;
+                    s.cycles += opcodes[0xc6].cycles + opcodes[0x47].cycles;
+                    return true;
+                }
+            }
+            return false;
+        case 0xe6:
+            switch (second) {
+                case 0xfe: { // ANI; CPI
+                    e.ana(m[static_cast<uint16_t>(pc + 1)]);
+                    e.cmp(m[static_cast<uint16_t>(next + 1)]);
+                    s.pc = next + opcodes[0xfe].length;
+                    s.cycles += opcodes[0xe6].cycles + opcodes[0xfe].cycles;
+                    return true;
+                }
+            }
+            return false;
+        case 0xfe:
+            switch (second) {
+                case 0x78: { // CPI; MOV A,B
+                    e.cmp(m[static_cast<uint16_t>(pc + 1)]);
+                    s.a = s.b;
+                    s.pc = next + opcodes[0x78].length;
+                    s.cycles += opcodes[0xfe].cycles + opcodes[0x78].cycles;
+                    return true;
+                }
+            }
+            return false;
+        default: return false;
+    }
+}
+
+}
+
+#endif //CPU8080_SUPERINSTRUCTIONS_H
@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+"""Generates superinstructions.h, fused handlers for the hottest opcode pairs of a profile.
+
+The profiles are `cpu8080 profile` reports; their "hottest opcode pairs" sections are summed and
+the top pairs this script can fuse are kept. A pair can be fused when its first op neither
+branches nor does I/O and its second is one of those or a jump.
+
+    cpu8080 profile --top 200 workloads > workloads.txt
+    superinstructions.py workloads.txt                    # rewrites lib/superinstructions.h
+    superinstructions.py -n 24 workloads.txt invaders.txt
+"""
+
+import argparse
+import os
+import re
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+REGISTERS = ["b", "c", "d", "e", "h", "l", "M", "a"]
+PAIRS = {0x00: "s.bc", 0x10: "s.de", 0x20: "s.hl", 0x30: "s.sp"}
+HL = "s.hl"
+PAIR_LINE = re.compile(r"^\s*(\d+)\s+[\d.]+%\s+([0-9a-f]{2}) ([0-9a-f]{2})\t(.*)$")
+
+
+def operand(register):
+    return "m[%s]" % HL if register == "M" else "s." + register
+
+
+def semantics(op, at):
+    """C++ statements for op at the address held by the variable at, and the address it writes.
+
+    None for ops that are not fused.
+    """
+    data = "m[static_cast<uint16_t>(%s + 1)]" % at
+    address = "word(m, %s + 1)" % at
+    if 0x40 <= op <= 0x7f and op != 0x76:
+        dst, src = REGISTERS[(op >> 3) & 7], REGISTERS[op & 7]
+        return ["%s = %s;" % (operand(dst), operand(src))], HL if dst == "M" else None
+    if 0x80 <= op <= 0xbf:
+        source = operand(REGISTERS[op & 7])
+        return [alu((op >> 3) & 7, source)], None
+    if op & 0xc7 == 0xc6:
+        return [alu((op >> 3) & 7, data)], None
+    if op & 0xc7 == 0x06:
+        register = REGISTERS[(op >> 3) & 7]
+        return ["%s = %s;" % (operand(register), data)], HL if register == "M" else None
+    if op & 0xc7 in (0x04, 0x05):
+        register = REGISTERS[(op >> 3) & 7]
+        name = "inr" if op & 1 == 0 else "dcr"
+        return ["e.%s(%s);" % (name, operand(register))], HL if register == "M" else None
+    group = op & 0x30
+    if op & 0xcf == 0x01:
+        return ["%s = %s;" % (PAIRS[group], address)], None
+    if op & 0xcf in (0x03, 0x0b):
+        name = "inx" if op & 0x08 == 0 else "dcx"
+        return ["e.%s(%s);" % (name, PAIRS[group])], None
+    if op & 0xcf == 0x09:
+        return ["e.dad(%s);" % PAIRS[group]], None
+    if op in (0x0a, 0x1a):
+        return ["e.ldax(%s);" % PAIRS[op & 0x30]], None
+    if op in (0x02, 0x12):
+        return ["e.stax(%s);" % PAIRS[op & 0x30]], PAIRS[op & 0x30]
+    if op == 0x3a:
+        return ["s.a = m[%s];" % address], None
+    if op == 0x32:
+        return ["m[%s] = s.a;" % address], address
+    if op == 0xeb:
+        return ["std::swap(s.de, s.hl);"], None
+    if op == 0x2f:
+        return ["s.a = ~s.a;"], None
+    if op == 0x37:
+        return ["s.controls.c = true;"], None
+    if op == 0x3f:
+        return ["s.controls.c = !s.controls.c;"], None
+    if op == 0x00:
+        return [], None
+    return None
+
+
+def alu(kind, source):
+    return [
+        "e.add(s.a, %s);", "e.adc(s.a, %s);", "e.sub(s.a, %s);", "e.sbb(s.a, %s);",
+        "e.ana(%s);", "e.xra(%s);", "e.ora(%s);", "e.cmp(%s);",
+    ][kind] % source
+
+
+JUMP_CONDITIONS = {
+    0xc3: "true", 0xc2: "!s.controls.z", 0xca: "s.controls.z", 0xd2: "!s.controls.c", 0xda: "s.controls.c",
+    0xe2: "!s.controls.p", 0xea: "s.controls.p", 0xf2: "!s.controls.s", 0xfa: "s.controls.s",
+}
+
+
+def handler(first, second, name):
+    """The case for the pair, or None when it cannot be fused."""
+    head = semantics(first, "pc")
+    if head is None:
+        return None
+    lines = ["case 0x%02x: { // %s" % (second, name)]
+    statements, written = head
+    if written:
+        # A write into the second op would change what the interpreter fetches next.
+        lines.append("if (static_cast<uint16_t>(%s - next) < opcodes[0x%02x].length) { return false; }"
+                     % (written, second))
+    lines += statements
+    if second in JUMP_CONDITIONS:
+        target = "word(m, next + 1)"
+        fallthrough = "static_cast<uint16_t>(next + 3)"
+        lines.append("s.pc = %s ? %s : %s;" % (JUMP_CONDITIONS[second], target, fallthrough)
+                     if second != 0xc3 else "s.pc = %s;" % target)
+    else:
+        tail = semantics(second, "next")
+        if tail is None:
+            return None
+        lines += tail[0]
+        lines.append("s.pc = next + opcodes[0x%02x].length;" % second)
+    lines.append("s.cycles += opcodes[0x%02x].cycles + opcodes[0x%02x].cycles;" % (first, second))
+    lines.append("return true;")
+    return lines
+
+
+def read_profiles(paths):
+    counts = {}
+    names = {}
+    for path in paths:
+        in_pairs = False
+        with open(path) as f:
+            for line in f:
+                if line.startswith("hottest opcode pairs"):
+                    in_pairs = True
+                    continue
+                if in_pairs and not line.strip():
+                    break
+                match = PAIR_LINE.match(line) if in_pairs else None
+                if match:
+                    pair = (int(match.group(2), 16), int(match.group(3), 16))
+                    counts[pair] = counts.get(pair, 0) + int(match.group(1))
+                    names[pair] = match.group(4).strip()
+    return counts, names
+
+
+def generate(chosen, sources):
+    out = []
+    out.append("//\n// Generated by lib/superinstructions.py from %s; do not edit.\n//\n" % ", ".join(sources))
+    out.append("#ifndef CPU8080_SUPERINSTRUCTIONS_H\n#define CPU8080_SUPERINSTRUCTIONS_H\n")
+    out.append("#include <array>\n#include <stdint.h>\n#include <utility>\n")
+    out.append('#include "emulator.h"\n#include "opcodes.h"\n')
+    out.append("// Fused handlers for the hottest opcode pairs of a profile: Emulator::run runs each pair in one")
+    out.append("// dispatch, with the state the two ops would have left one after the other.")
+    out.append("namespace superinstructions {\n")
+    out.append("// The pairs, hottest first, as first << 8 | second.")
+    out.append("inline constexpr std::array<uint16_t, %d> pairs {" % len(chosen))
+    for (first, second), name, _ in chosen:
+        out.append("    0x%02x%02x,  // %s" % (first, second, name))
+    out.append("};\n")
+    out.append("// Whether a pair starts with the opcode.")
+    out.append("inline constexpr std::array<bool, 256> starts = [] {")
+    out.append("    std::array<bool, 256> table {};")
+    out.append("    for (uint16_t fused: pairs) { table[fused >> 8] = true; }")
+    out.append("    return table;")
+    out.append("}();\n")
+    out.append("// Bit first << 8 | second is set for the pairs.")
+    out.append("inline constexpr std::array<uint64_t, (1 << 16) / 64> bits = [] {")
+    out.append("    std::array<uint64_t, (1 << 16) / 64> table {};")
+    out.append("    for (uint16_t fused: pairs) { table[fused >> 6] |= uint64_t {1} << (fused & 63); }")
+    out.append("    return table;")
+    out.append("}();\n")
+    out.append("inline bool fuses(Byte first, Byte second) {")
+    out.append("    uint16_t const key = first << 8 | second;")
+    out.append("    return (bits[key >> 6] >> (key & 63)) & 1;")
+    out.append("}\n")
+    out.append("inline uint16_t word(Byte const* m, int at) {")
+    out.append("    return m[static_cast<uint16_t>(at)] | m[static_cast<uint16_t>(at + 1)] << 8;")
+    out.append("}\n")
+    out.append("// Runs the pair of first, at pc, and second, at next. False, changing nothing, when first")
+    out.append("// would write into the second op.")
+    out.append("inline bool run(Emulator& e, uint16_t pc, Byte first, uint16_t next, Byte second) {")
+    out.append("    Status& s = e.status_;")
+    out.append("    Byte* m = s.memory.data();")
+    out.append("    switch (first) {")
+    for first in sorted({pair[0] for pair, _, _ in chosen}):
+        out.append("        case 0x%02x:" % first)
+        out.append("            switch (second) {")
+        for (_, _, lines) in [c for c in chosen if c[0][0] == first]:
+            out.append("                " + lines[0])
+            out += ["                    " + line for line in lines[1:]]
+            out.append("                }")
+        out.append("            }")
+        out.append("            return false;")
+    out.append("        default: return false;")
+    out.append("    }")
+    out.append("}\n")
+    out.append("}\n")
+    out.append("#endif //CPU8080_SUPERINSTRUCTIONS_H")
+    return "\n".join(out) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("profiles", nargs="+", help="cpu8080 profile reports")
+    parser.add_argument("-n", type=int, default=16, help="how many pairs to fuse")
+    parser.add_argument("-o", "--output", default=os.path.join(HERE, "superinstructions.h"))
+    args = parser.parse_args()
+
+    counts, names = read_profiles(args.profiles)
+    chosen = []
+    for pair in sorted(counts, key=lambda p: (-counts[p], p)):
+        lines = handler(pair[0], pair[1], names[pair])
+        if lines is not None:
+            chosen.append((pair, names[pair], lines))
+        if len(chosen) == args.n:
+            break
+    if not chosen:
+        sys.exit("no pair in %s can be fused" % ", ".join(args.profiles))
+    with open(args.output, "w") as f:
+        f.write(generate(chosen, [os.path.basename(p) for p in args.profiles]))
+    print("%d pairs written to %s" % (len(chosen), args.output))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,150 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "timeline.h"
+
+#include <algorithm>
+#include <cstring>
+
+Timeline::Timeline(uint64_t interval, size_t memoryBudget): interval_(std::max<uint64_t>(interval, 1)),
+                                                              memoryBudget_(memoryBudget),
+                                                              interrupts_(std::make_shared<Interrupts>()) {}
+
+Stop Timeline::run(Emulator& emulator, uint64_t cycles) {
+    Status const& status = emulator.status_;
+    if (history_.empty() || status.cycles < history_.back().registers.cycles) {
+        clear();    // A new run or a reset cycle count; the old history no longer leads here.
+        snapshot(emulator);
+    }
+    listen(emulator);
+    uint64_t const end = status.cycles + cycles;
+    Stop stop {StopReason::CYCLE_BUDGET, status.pc, status.memory[status.pc]};
+    while (status.cycles < end) {
+        if (status.cycles >= history_.back().registers.cycles + interval_) { snapshot(emulator); }
+        uint64_t const until = std::min(end, history_.back().registers.cycles + interval_);
+        stop = emulator.run(until - status.cycles);
+        if (stop.reason != StopReason::CYCLE_BUDGET) { return stop; }
+    }
+    return stop;
+}
+
+void Timeline::snapshot(Emulator const& emulator) {
+    Status const& s = emulator.status_;
+    ShiftRegister const* shifter = emulator.shiftRegister();
+    Snapshot next {{s.a, s.b, s.c, s.d, s.e, s.h, s.l, s.sp, s.pc, s.cycles, s.controls, s.is_interrupt_enabled,
+                    shifter ? *shifter : ShiftRegister {}}, {}};
+    Snapshot const* previous = history_.empty() ? nullptr : &history_.back();
+    for (size_t i = 0; i < next.pages.size(); ++i) {
+        Byte const* memory = s.memory.data() + i * sizeof(Page);
+        if (previous && std::memcmp(previous->pages[i]->data(), memory, sizeof(Page)) == 0) {
+            next.pages[i] = previous->pages[i];
+            continue;
+        }
+        auto page = std::make_shared<Page>();
+        std::memcpy(page->data(), memory, sizeof(Page));
+        next.pages[i] = std::move(page);
+        ++pages_;
+    }
+    if (previous && previous->registers.cycles == s.cycles) {
+        release(history_.back());
+        history_.pop_back();
+    }
+    history_.push_back(std::move(next));
+    while (history_.size() > 1 && memoryUsed() > memoryBudget_) {
+        release(history_.front());
+        history_.pop_front();
+        interrupts_->erase(interrupts_->begin(), interruptsFrom(oldestCycle()));
+    }
+}
+
+bool Timeline::seek(Emulator& emulator, uint64_t cycle) {
+    Status& status = emulator.status_;
+    if (history_.empty() || cycle < oldestCycle() || cycle > status.cycles) { return false; }
+    auto const after = std::upper_bound(history_.begin(), history_.end(), cycle, [](uint64_t c, Snapshot const& s) {
+        return c < s.registers.cycles;
+    });
+    Snapshot const& base = *std::prev(after);
+
+    // The first pass finds where the op or interrupt spanning cycle starts; a second one is needed
+    // to stop there when cycle is not itself a boundary. Replayed interrupts are not recorded again.
+    emulator.setInterruptListener({});
+    restore(emulator, base);
+    auto next = interruptsFrom(base.registers.cycles);
+    uint64_t boundary = status.cycles;
+    while (status.cycles < cycle) {
+        boundary = status.cycles;
+        replay(emulator, next);
+        if (status.cycles == boundary) { break; }   // Stuck on an unimplemented op.
+    }
+    if (status.cycles > cycle) {
+        restore(emulator, base);
+        next = interruptsFrom(base.registers.cycles);
+        while (status.cycles < boundary) { replay(emulator, next); }
+    }
+    listen(emulator);
+
+    std::for_each(after, history_.end(), [this](Snapshot const& s) { release(s); });
+    history_.erase(after, history_.end());
+    interrupts_->erase(interruptsFrom(status.cycles), interrupts_->end());
+    return true;
+}
+
+bool Timeline::stepBack(Emulator& emulator) {
+    return emulator.status_.cycles > 0 && seek(emulator, emulator.status_.cycles - 1);
+}
+
+void Timeline::clear() {
+    history_.clear();
+    interrupts_->clear();
+    pages_ = 0;
+}
+
+void Timeline::listen(Emulator& emulator) {
+    std::weak_ptr<Interrupts> const log = interrupts_;
+    emulator.setInterruptListener([log](uint64_t cycles, Byte vector) {
+        if (auto const interrupts = log.lock()) { interrupts->push_back({cycles, vector}); }
+    });
+}
+
+void Timeline::restore(Emulator& emulator, Snapshot const& snapshot) const {
+    Status& s = emulator.status_;
+    Registers const& r = snapshot.registers;
+    s.a = r.a;
+    s.b = r.b;
+    s.c = r.c;
+    s.d = r.d;
+    s.e = r.e;
+    s.h = r.h;
+    s.l = r.l;
+    s.sp = r.sp;
+    s.pc = r.pc;
+    s.cycles = r.cycles;
+    s.controls = r.controls;
+    s.is_interrupt_enabled = r.interruptEnabled;
+    if (ShiftRegister* shifter = emulator.shiftRegister()) { *shifter = r.shifter; }
+    for (size_t i = 0; i < snapshot.pages.size(); ++i) {
+        std::memcpy(s.memory.data() + i * sizeof(Page), snapshot.pages[i]->data(), sizeof(Page));
+    }
+}
+
+void Timeline::replay(Emulator& emulator, Interrupts::const_iterator& next) const {
+    if (next != interrupts_->end() && next->cycles == emulator.status_.cycles) {
+        emulator.interrupt((next++)->vector);
+    } else {
+        emulator.emulateOp();
+    }
+}
+
+Timeline::Interrupts::const_iterator Timeline::interruptsFrom(uint64_t cycles) const {
+    return std::lower_bound(interrupts_->cbegin(), interrupts_->cend(), cycles, [](Interrupt const& i, uint64_t c) {
+        return i.cycles < c;
+    });
+}
+
+// Accounts for the pages only snapshot holds; call it just before dropping snapshot.
+void Timeline::release(Snapshot const& snapshot) {
+    for (auto const& page: snapshot.pages) {
+        if (page.use_count() == 1) { --pages_; }
+    }
+}
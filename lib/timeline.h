@@ -0,0 +1,90 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_TIMELINE_H
+#define CPU8080_TIMELINE_H
+
+#include <array>
+#include <deque>
+#include <memory>
+
+#include "emulator.h"
+
+// Reverse execution for one Emulator. run() snapshots the registers and memory every interval
+// states into a history bounded by a memory budget, and from then on records every interrupt the
+// emulator takes, between runs included; seek() and stepBack() restore the nearest snapshot at or
+// before the target and re-execute forward to it, taking each recorded interrupt again at the
+// cycle count it was taken at. That is exact because ops only depend on Status and on what IN
+// returns, as long as the ports answer by cycle count the way a MoviePlayer does. Of the devices,
+// only the emulator's shift register is part of a snapshot; any other change made by hand needs a
+// snapshot().
+//
+// Memory is kept as 256-byte pages shared between snapshots: taking one compares every page with
+// the previous snapshot and copies only the pages that differ, so the run loop itself needs no
+// write tracking and a snapshot of a program that touches a few pages costs a few pages.
+class Timeline {
+public:
+    explicit Timeline(uint64_t interval = 1000000, size_t memoryBudget = 16 << 20);
+    Timeline(Timeline const&) = delete;
+    Timeline& operator=(Timeline const&) = delete;
+
+    // Emulator::run with snapshots: stops and reports the same way, but never runs more than
+    // interval states without taking one.
+    Stop run(Emulator& emulator, uint64_t cycles);
+    // Takes a snapshot now. Call it after changing the emulator's state by hand, e.g. from a
+    // debugger, or seeking past the change replays the old state.
+    void snapshot(Emulator const& emulator);
+
+    // Moves emulator back to the last op boundary at or before cycle. History after that point is
+    // dropped, as the emulator may take a different path from there. False, leaving emulator
+    // alone, when cycle lies before the oldest snapshot or after the current cycle count.
+    bool seek(Emulator& emulator, uint64_t cycle);
+    // Undoes the last op executed. False when the history does not reach back that far.
+    bool stepBack(Emulator& emulator);
+
+    void clear();
+    size_t snapshots() const { return history_.size(); }
+    size_t memoryUsed() const {
+        return pages_ * sizeof(Page) + history_.size() * sizeof(Snapshot) + interrupts_->size() * sizeof(Interrupt);
+    }
+    uint64_t oldestCycle() const { return history_.empty() ? 0 : history_.front().registers.cycles; }
+
+private:
+    using Page = std::array<Byte, 256>;
+
+    struct Registers {
+        Byte a, b, c, d, e, h, l;
+        uint16_t sp, pc;
+        uint64_t cycles;
+        Controls controls;
+        bool interruptEnabled;
+        ShiftRegister shifter;      // When the emulator has one.
+    };
+    struct Snapshot {
+        Registers registers;
+        std::array<std::shared_ptr<Page const>, 256> pages;
+    };
+    struct Interrupt {
+        uint64_t cycles;    // Before it was taken.
+        Byte vector;
+    };
+    using Interrupts = std::deque<Interrupt>;
+
+    // Has emulator record the interrupts it takes into interrupts_ for as long as this lives.
+    void listen(Emulator& emulator);
+    void restore(Emulator& emulator, Snapshot const& snapshot) const;
+    // Takes the interrupt recorded at the current cycle count, if next is one, or else runs an op.
+    void replay(Emulator& emulator, Interrupts::const_iterator& next) const;
+    Interrupts::const_iterator interruptsFrom(uint64_t cycles) const;
+    void release(Snapshot const& snapshot);
+
+    uint64_t interval_;
+    size_t memoryBudget_;
+    std::deque<Snapshot> history_;  // Oldest first; a ring trimmed from the front to the budget.
+    size_t pages_ {0};              // Distinct pages referenced by history_.
+    // Oldest first, from the oldest snapshot on. The emulator's listener only holds it weakly.
+    std::shared_ptr<Interrupts> interrupts_;
+};
+
+#endif //CPU8080_TIMELINE_H
@@ -0,0 +1,161 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "workloads.h"
+
+#include <algorithm>
+
+namespace {
+
+std::vector<Byte> assemble(std::vector<std::pair<uint16_t, std::vector<Byte>>> const& chunks) {
+    std::vector<Byte> program;
+    for (auto const& [address, bytes]: chunks) {
+        if (program.size() < address + bytes.size()) { program.resize(address + bytes.size(), 0x00); }
+        std::copy(bytes.begin(), bytes.end(), program.begin() + address);
+    }
+    return program;
+}
+
+// Copies 1 KiB from $2000 to $3000 with the LDAX/MOV/INX/DCX loop.
+Workload memcpyLoop() {
+    return {"memcpy", assemble({{0x0000, {
+        0x31, 0x00, 0xf0,   // 0000 LXI SP,$f000
+        0x11, 0x00, 0x20,   // 0003 LXI D,$2000
+        0x21, 0x00, 0x30,   // 0006 LXI H,$3000
+        0x01, 0x00, 0x04,   // 0009 LXI B,$0400
+        0x1a,               // 000c LDAX D
+        0x77,               // 000d MOV M,A
+        0x13,               // 000e INX D
+        0x23,               // 000f INX H
+        0x0b,               // 0010 DCX B
+        0x78,               // 0011 MOV A,B
+        0xb1,               // 0012 ORA C
+        0xc2, 0x0c, 0x00,   // 0013 JNZ $000c
+        0x76,               // 0016 HLT
+    }}}), 0x0016};
+}
+
+// Multiplies every 8-bit value by $5b with a shift-and-add subroutine.
+Workload multiply() {
+    return {"multiply", assemble({{0x0000, {
+        0x31, 0x00, 0xf0,   // 0000 LXI SP,$f000
+        0x06, 0x00,         // 0003 MVI B,$00
+        0x78,               // 0005 MOV A,B
+        0x1e, 0x5b,         // 0006 MVI E,$5b
+        0xcd, 0x20, 0x00,   // 0008 CALL $0020
+        0x05,               // 000b DCR B
+        0xc2, 0x05, 0x00,   // 000c JNZ $0005
+        0x76,               // 000f HLT
+    }}, {0x0020, {          // HL <- A * E
+        0x21, 0x00, 0x00,   // 0020 LXI H,$0000
+        0x16, 0x00,         // 0023 MVI D,$00
+        0x0e, 0x08,         // 0025 MVI C,$08
+        0x29,               // 0027 DAD H
+        0x17,               // 0028 RAL
+        0xd2, 0x2d, 0x00,   // 0029 JNC $002d
+        0x19,               // 002c DAD D
+        0x0d,               // 002d DCR C
+        0xc2, 0x27, 0x00,   // 002e JNZ $0027
+        0xc9,               // 0031 RET
+    }}}), 0x000f};
+}
+
+// Counts a packed BCD score at $2000 up 4000 times, decimal adjusting each byte by hand.
+Workload bcdCounter() {
+    return {"bcd", assemble({{0x0000, {
+        0x31, 0x00, 0xf0,   // 0000 LXI SP,$f000
+        0x11, 0xa0, 0x0f,   // 0003 LXI D,$0fa0
+        0x21, 0x00, 0x20,   // 0006 LXI H,$2000
+        0xcd, 0x20, 0x00,   // 0009 CALL $0020
+        0x1b,               // 000c DCX D
+        0x7a,               // 000d MOV A,D
+        0xb3,               // 000e ORA E
+        0xc2, 0x06, 0x00,   // 000f JNZ $0006
+        0x76,               // 0012 HLT
+    }}, {0x0020, {          // (HL) <- (HL) + 1 in BCD, carrying into the following bytes
+        0x7e,               // 0020 MOV A,M
+        0xc6, 0x01,         // 0021 ADI $01
+        0x47,               // 0023 MOV B,A
+        0xe6, 0x0f,         // 0024 ANI $0f
+        0xfe, 0x0a,         // 0026 CPI $0a
+        0x78,               // 0028 MOV A,B
+        0xda, 0x3a, 0x00,   // 0029 JC $003a
+        0xc6, 0x06,         // 002c ADI $06
+        0xfe, 0xa0,         // 002e CPI $a0
+        0xda, 0x3a, 0x00,   // 0030 JC $003a
+        0xaf,               // 0033 XRA A
+        0x77,               // 0034 MOV M,A
+        0x23,               // 0035 INX H
+        0xc3, 0x20, 0x00,   // 0036 JMP $0020
+        0x00,               // 0039 NOP
+        0x77,               // 003a MOV M,A
+        0xc9,               // 003b RET
+    }}}), 0x0012};
+}
+
+// Adds the packed BCD constant 1237 to a 4-byte total at $2000 4000 times with ADC and DAA.
+Workload bcdAdd() {
+    return {"daa", assemble({{0x0000, {
+        0x31, 0x00, 0xf0,   // 0000 LXI SP,$f000
+        0x01, 0xa0, 0x0f,   // 0003 LXI B,$0fa0
+        0xc5,               // 0006 PUSH B
+        0x11, 0x40, 0x00,   // 0007 LXI D,$0040
+        0x21, 0x00, 0x20,   // 000a LXI H,$2000
+        0x0e, 0x04,         // 000d MVI C,$04
+        0xaf,               // 000f XRA A
+        0x1a,               // 0010 LDAX D
+        0x8e,               // 0011 ADC M
+        0x27,               // 0012 DAA
+        0x77,               // 0013 MOV M,A
+        0x13,               // 0014 INX D
+        0x23,               // 0015 INX H
+        0x0d,               // 0016 DCR C
+        0xc2, 0x10, 0x00,   // 0017 JNZ $0010
+        0xc1,               // 001a POP B
+        0x0b,               // 001b DCX B
+        0x78,               // 001c MOV A,B
+        0xb1,               // 001d ORA C
+        0xc2, 0x06, 0x00,   // 001e JNZ $0006
+        0x76,               // 0021 HLT
+    }}, {0x0040, {
+        0x37, 0x12, 0x00, 0x00,
+    }}}), 0x0021};
+}
+
+}
+
+std::vector<Workload> const& standardWorkloads() {
+    static std::vector<Workload> const workloads {memcpyLoop(), multiply(), bcdCounter(), bcdAdd()};
+    return workloads;
+}
+
+void loadWorkload(Emulator& emulator, Workload const& workload) {
+    Status& status = emulator.status_;
+    std::fill(status.memory.begin(), status.memory.end(), 0);
+    std::copy(workload.program.begin(), workload.program.end(), status.memory.begin());
+    status.cycles = 0;
+    status.pc = 0;
+    status.sp = 0;
+    status.bc = 0;
+    status.de = 0;
+    status.hl = 0;
+    status.a = 0;
+    status.controls = Controls {};
+    status.is_interrupt_enabled = true;
+}
+
+uint64_t runWorkload(Emulator& emulator, Workload const& workload) {
+    Status const& status = emulator.status_;
+    loadWorkload(emulator, workload);
+    uint64_t ops = 0;
+    while (status.pc != workload.exit) {
+        StopReason const reason = emulator.emulateOp();
+        if (reason != StopReason::NONE) {
+            ops += reason == StopReason::HALTED;
+            break;
+        }
+        ++ops;
+    }
+    return ops;
+}
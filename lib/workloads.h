@@ -0,0 +1,29 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#ifndef CPU8080_WORKLOADS_H
+#define CPU8080_WORKLOADS_H
+
+#include <string>
+#include <vector>
+
+#include "emulator.h"
+
+// A small guest program with a known end, used to measure and train the CPU core.
+struct Workload {
+    std::string name;
+    std::vector<Byte> program;  // Loaded at 0x0000.
+    uint16_t exit;              // The PC reached once the routine is done; never executed.
+};
+
+// Block copy, shift-and-add multiply, BCD counter and DAA based BCD addition routines, in that order.
+std::vector<Workload> const& standardWorkloads();
+
+// Clears memory, the registers, flags and cycle count and loads workload, to run from $0000.
+void loadWorkload(Emulator& emulator, Workload const& workload);
+// Loads workload and runs it to its exit, or until an op stops it (HLT, or an unimplemented opcode
+// under the HALT policy). Returns the number of ops executed.
+uint64_t runWorkload(Emulator& emulator, Workload const& workload);
+
+#endif //CPU8080_WORKLOADS_H
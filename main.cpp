@@ -1,10 +1,348 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cpm.h>
 #include <disassembler.h>
 #include <emulator.h>
+#include <gdbstub.h>
+#include <inputscript.h>
+#include <invaders.h>
+#include <metrics.h>
+#include <metricsserver.h>
+#include <movie.h>
+#include <pacer.h>
+#ifdef __linux__
+#include <perfcounters.h>
+#endif
+#include <profiler.h>
+#include <rom.h>
+#include <sound.h>
+#include <workloads.h>
+
+// cpu8080 bulk [-j threads] <output directory> <image or directory>...
+int bulk(std::vector<std::string> args) {
+    unsigned threads = std::thread::hardware_concurrency();
+    if (args.size() > 1 && args[0] == "-j") {
+        threads = std::stoul(args[1]);
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if (args.size() < 2) {
+        std::cerr << "usage: cpu8080 bulk [-j threads] <output directory> <image or directory>..." << std::endl;
+        return 2;
+    }
+
+    Disassembler const disassembler;
+    auto images = Disassembler::collectImages({args.begin() + 1, args.end()});
+    BulkReport report = disassembler.disassembleBulk(images, args[0], threads);
+    for (auto const& error: report.errors) { std::cerr << error << std::endl; }
+    std::cout << report.images << " images, " << report.bytes << " bytes in " << report.seconds << " s ("
+              << report.megabytesPerSecond() << " MB/s)" << std::endl;
+    return report.errors.empty() ? 0 : 1;
+}
+
+// cpu8080 profile [--top n] <rom | workloads> [cycles]
+int profile(std::vector<std::string> args) {
+    size_t top = 20;
+    if (args.size() > 1 && args[0] == "--top") {
+        top = std::stoul(args[1]);
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if (args.empty()) {
+        std::cerr << "usage: cpu8080 profile [--top n] <rom | workloads> [cycles]" << std::endl;
+        return 2;
+    }
+    Emulator emulator {};
+    Profiler profiler;
+    if (args[0] == "workloads") {
+        // Every standard workload to its end, as the PGO training run does.
+        for (auto const& workload: standardWorkloads()) {
+            std::fill(emulator.status_.memory.begin(), emulator.status_.memory.end(), 0);
+            std::copy(workload.program.begin(), workload.program.end(), emulator.status_.memory.begin());
+            emulator.status_.pc = 0;
+            while (emulator.status_.pc != workload.exit) { emulator.run(1, profiler); }
+        }
+        std::cout << profiler.report(emulator.status_.memory, top) << std::endl;
+        return 0;
+    }
+    emulator.setMemory(args[0]);
+    Stop const stop = emulator.run(args.size() > 1 ? std::stoull(args[1]) : 2000000 * 10ull, profiler);
+    std::cout << profiler.report(emulator.status_.memory, top) << "\nstopped: " << stop.describe() << std::endl;
+    return 0;
+}
+
+#ifdef __linux__
+// cpu8080 perf <rom | workloads> [cycles]
+int perf(std::vector<std::string> const& args) {
+    if (args.empty()) {
+        std::cerr << "usage: cpu8080 perf <rom | workloads> [cycles]" << std::endl;
+        return 2;
+    }
+    PerfCounters counters;
+    PerfProfiler profiler(counters);
+    Emulator emulator {};
+    if (args[0] == "workloads") {
+        for (auto const& workload: standardWorkloads()) {
+            counters.start();
+            uint64_t const ops = runWorkload(emulator, workload);
+            counters.stop();
+            std::cout << workload.name << ": " << describeRun(counters, counters.read(), ops);
+        }
+        // Then once more op by op, as profile does, for the classes.
+        counters.start();
+        for (auto const& workload: standardWorkloads()) {
+            std::fill(emulator.status_.memory.begin(), emulator.status_.memory.end(), 0);
+            std::copy(workload.program.begin(), workload.program.end(), emulator.status_.memory.begin());
+            emulator.status_.pc = 0;
+            while (emulator.status_.pc != workload.exit) { emulator.run(1, profiler); }
+        }
+        counters.stop();
+        std::cout << '\n' << profiler.report();
+        return 0;
+    }
+    uint64_t const cycles = args.size() > 1 ? std::stoull(args[1]) : 2000000 * 10ull;
+    emulator.setMemory(args[0]);
+    OpCounter ops;
+    counters.start();
+    emulator.run(cycles, ops);
+    counters.stop();
+    std::cout << describeRun(counters, counters.read(), ops.ops);
+
+    Emulator profiled {};
+    profiled.setMemory(args[0]);
+    counters.start();
+    Stop const stop = profiled.run(cycles, profiler);
+    counters.stop();
+    std::cout << '\n' << profiler.report() << "\nstopped: " << stop.describe() << std::endl;
+    return 0;
+}
+#endif
+
+// cpu8080 exerciser <program.com>...
+int exerciser(std::vector<std::string> const& args) {
+    if (args.empty()) {
+        std::cerr << "usage: cpu8080 exerciser <program.com>..." << std::endl;
+        return 2;
+    }
+    bool failed = false;
+    for (auto const& filename: args) {
+        Emulator emulator {};
+        cpm::RunResult result = cpm::run(emulator, mapRom(filename)->bytes(), UINT64_MAX,
+                                         [](char c) { std::cout << c << std::flush; });
+        std::cout << '\n' << filename << ": " << result.instructions << " instructions, " << result.cycles
+                  << " cycles in " << std::fixed << std::setprecision(2) << result.seconds << " s ("
+                  << result.cycles / result.seconds / 1e6 << " MHz)" << std::defaultfloat << std::endl;
+        if (!result.finished) {
+            std::cout << "  did not finish: " << result.stop.describe() << std::endl;
+            failed = true;
+        }
+        for (auto const& group: cpm::parseGroups(result.output)) {
+            if (!group.passed) {
+                std::cout << "  CRC mismatch in " << group.name << ": " << group.detail << std::endl;
+                failed = true;
+            }
+        }
+    }
+    return failed ? 1 : 0;
+}
+
+// cpu8080 gdb <rom> [port | socket path]
+int gdb(std::vector<std::string> const& args) {
+    if (args.empty()) {
+        std::cerr << "usage: cpu8080 gdb <rom> [port | socket path]" << std::endl;
+        return 2;
+    }
+    Emulator emulator {};
+    emulator.setMemory(args[0]);
+    std::string const where = args.size() > 1 ? args[1] : "1234";
+    bool const isPort = where.find_first_not_of("0123456789") == std::string::npos;
+    GdbStub stub = isPort ? GdbStub(static_cast<uint16_t>(std::stoul(where))) : GdbStub(where);
+    std::cout << "waiting for gdb on " << (isPort ? "127.0.0.1:" + std::to_string(stub.port()) : where) << std::endl;
+    stub.serve(emulator);
+    return 0;
+}
+
+// cpu8080 replay [-j threads] <rom directory> <movie>...
+int replay(std::vector<std::string> args) {
+    unsigned threads = std::thread::hardware_concurrency();
+    if (args.size() > 1 && args[0] == "-j") {
+        threads = std::stoul(args[1]);
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if (args.size() < 2) {
+        std::cerr << "usage: cpu8080 replay [-j threads] <rom directory> <movie>..." << std::endl;
+        return 2;
+    }
+
+    std::vector<RomPart> const rom = spaceInvadersParts(args[0]);
+    std::vector<std::string> const movies {args.begin() + 1, args.end()};
+    std::vector<std::string> results(movies.size());
+    std::atomic<size_t> next {0};
+    std::atomic<bool> failed {false};
+    auto const worker = [&] {
+        for (size_t i; (i = next++) < movies.size();) {
+            try {
+                Movie const movie = Movie::load(movies[i]);
+                Emulator emulator;
+                emulator.setMemory(rom);
+                emulator.idioms_.setEnabled(true);
+                Invaders machine;
+                MoviePlayer player(movie, machine);
+                emulator.setPorts(&player);
+                emulator.setShiftRegister(&machine.shiftRegister());
+                auto const start = std::chrono::steady_clock::now();
+                Stop stop {StopReason::CYCLE_BUDGET};
+                while (emulator.status_.cycles < movie.endCycles && stop.reason == StopReason::CYCLE_BUDGET) {
+                    stop = machine.runFrame(emulator);
+                }
+                double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                // A recording that ended on a stop replays faithfully if it stops at the same place.
+                bool const same = emulator.status_.cycles == movie.endCycles && stateHash(emulator) == movie.endHash;
+                failed = failed || !same;
+                std::ostringstream line;
+                line << movies[i] << ": " << Invaders::frame(movie.endCycles) << " frames in " << std::fixed
+                     << std::setprecision(3) << seconds << " s (" << std::setprecision(0)
+                     << movie.endCycles / 2e6 / seconds << "x real time), " << (same ? "ok" : "DIVERGED");
+                if (stop.reason != StopReason::CYCLE_BUDGET) { line << " (" << stop.describe() << ")"; }
+                results[i] = line.str();
+            } catch (std::exception const& e) {
+                failed = true;
+                results[i] = e.what();
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < std::max(threads, 1u); ++t) { pool.emplace_back(worker); }
+    worker();
+    for (auto& thread: pool) { thread.join(); }
+    for (auto const& line: results) { std::cout << line << std::endl; }
+    return failed ? 1 : 0;
+}
+
+volatile std::sig_atomic_t interrupted = 0;    // Set by ^C during run.
+
+// cpu8080 run [--wav <file>] [--metrics <port | socket path>] [--input <script | ->] [--record <movie>]
+//             <rom directory> [seconds]
+int run(std::vector<std::string> args) {
+    std::string wav;
+    std::string metricsAt;
+    std::string inputFrom;
+    std::string recordTo;
+    while (args.size() > 1 && (args[0] == "--wav" || args[0] == "--metrics" || args[0] == "--input" || args[0] == "--record")) {
+        (args[0] == "--wav" ? wav : args[0] == "--metrics" ? metricsAt : args[0] == "--input" ? inputFrom : recordTo) = args[1];
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if (args.empty()) {
+        std::cerr << "usage: cpu8080 run [--wav <file>] [--metrics <port | socket path>] [--input <script | ->]"
+                     " [--record <movie>] <rom directory> [seconds]" << std::endl;
+        return 2;
+    }
+    Emulator emulator;
+    emulator.setMemory(spaceInvadersParts(args[0]));
+    emulator.idioms_.setEnabled(true);
+    Invaders machine;
+    machine.attach(emulator);
+    // The controls follow the script, read from a file or stdin ("-"), frame by frame.
+    InputScript script;
+    if (inputFrom == "-") {
+        script = InputScript::parse(std::cin, "stdin");
+    } else if (!inputFrom.empty()) {
+        script = InputScript::load(inputFrom);
+    }
+    // With --record every port read goes through the recorder, and the movie is saved at the end of
+    // the last frame run, which replay starts from cycle 0 to reproduce.
+    std::unique_ptr<MovieRecorder> recorder;
+    if (!recordTo.empty()) {
+        recorder = std::make_unique<MovieRecorder>(machine);
+        emulator.setPorts(recorder.get());
+    }
+    // With --wav the sound is mixed offline from the samples next to the ROM and nothing is paced.
+    std::unique_ptr<SoundBoard> sound;
+    if (!wav.empty()) {
+        unsigned const sampleRate = 44100;
+        sound = std::make_unique<SoundBoard>(SoundBoard::loadSamples(args[0], sampleRate), sampleRate, Invaders::clockHz);
+        machine.setSoundBoard(sound.get());
+    }
+    // Prometheus text at http://127.0.0.1:<port>/metrics or on the socket, served while running.
+    Metrics metrics;
+    InstanceMetrics instance(metrics, "0", Invaders::clockHz);
+    std::unique_ptr<MetricsServer> server;
+    if (!metricsAt.empty()) {
+        bool const isPort = metricsAt.find_first_not_of("0123456789") == std::string::npos;
+        server = isPort ? std::make_unique<MetricsServer>(metrics, static_cast<uint16_t>(std::stoul(metricsAt)))
+                        : std::make_unique<MetricsServer>(metrics, metricsAt);
+        machine.setMetrics(&instance);
+        std::cout << "metrics on " << (isPort ? "http://127.0.0.1:" + std::to_string(server->port()) + "/metrics" : metricsAt)
+                  << std::endl;
+    }
+    uint64_t const frames = (args.size() > 1 ? std::stod(args[1]) : 10) * 60;
+    Pacer pacer(std::chrono::nanoseconds(Invaders::cyclesPerFrame * 1000000000 / Invaders::clockHz));
+    // ^C ends the run after the current frame, so the movie and the WAV still get written.
+    std::signal(SIGINT, [](int) { interrupted = 1; });
+    for (uint64_t frame = 0; frame < frames && !interrupted; ++frame) {
+        auto const start = std::chrono::steady_clock::now();
+        script.apply(frame, machine);
+        Stop const stop = machine.runFrame(emulator);
+        if (server) {
+            std::chrono::duration<double> const spent = std::chrono::steady_clock::now() - start;
+            instance.recordFrame(emulator, spent.count(), sound ? nullptr : &pacer.stats());
+        }
+        if (stop.reason != StopReason::CYCLE_BUDGET) {
+            std::cout << "stopped: " << stop.describe() << std::endl;
+            break;
+        }
+        if (!sound) { pacer.wait(); }
+    }
+    std::signal(SIGINT, SIG_DFL);
+    if (recorder) {
+        Movie const movie = recorder->finish(emulator);
+        movie.save(recordTo);
+        std::cout << movie.reads.size() << " reads over " << Invaders::frame(movie.endCycles) << " frames recorded to "
+                  << recordTo << std::endl;
+    }
+    if (sound) {
+        sound->writeWav(wav);
+        std::cout << sound->offline().size() << " samples written to " << wav << std::endl;
+    } else {
+        std::cout << pacer.stats().describe() << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (!args.empty() && args[0] == "bulk") {
+        return bulk({args.begin() + 1, args.end()});
+    }
+    if (!args.empty() && args[0] == "profile") {
+        return profile({args.begin() + 1, args.end()});
+    }
+#ifdef __linux__
+    if (!args.empty() && args[0] == "perf") {
+        return perf({args.begin() + 1, args.end()});
+    }
+#endif
+    if (!args.empty() && args[0] == "exerciser") {
+        return exerciser({args.begin() + 1, args.end()});
+    }
+    if (!args.empty() && args[0] == "run") {
+        return run({args.begin() + 1, args.end()});
+    }
+    if (!args.empty() && args[0] == "replay") {
+        return replay({args.begin() + 1, args.end()});
+    }
+    if (!args.empty() && args[0] == "gdb") {
+        return gdb({args.begin() + 1, args.end()});
+    }
 
-int main() {
     Emulator emulator {};
-    emulator.setMemory("C:\\Users\\KarlE\\ClionProjects\\cpu8080\\space-invaders.rom");
+    emulator.setMemory(args.empty() ? "C:\\Users\\KarlE\\ClionProjects\\cpu8080\\space-invaders.rom" : args[0]);
     emulator.emulate();
 
     return 0;
@@ -0,0 +1,76 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <cpm.h>
+
+namespace {
+
+// Runs one of the exerciser binaries from CPU8080_EXERCISER_DIR, which are not part of the repository.
+void runExerciser(std::string const& name, std::string const& success) {
+    std::filesystem::path const path = std::filesystem::path(CPU8080_EXERCISER_DIR) / name;
+    if (!std::filesystem::exists(path)) { GTEST_SKIP() << path << " not found"; }
+
+    Emulator emulator;
+    cpm::RunResult result = cpm::run(emulator, mapRom(path.string())->bytes(), 10'000'000'000ull);
+    EXPECT_TRUE(result.finished) << result.output;
+    EXPECT_NE(result.output.find(success), std::string::npos) << result.output;
+    for (auto const& group: cpm::parseGroups(result.output)) {
+        EXPECT_TRUE(group.passed) << group.name << ": " << group.detail;
+    }
+}
+
+}
+
+TEST(CpmTest, BdosConsoleOutputAndWarmBoot) {
+    std::vector<Byte> const program {
+        0x0e, 0x09,         // 0100 MVI C,$09
+        0x11, 0x12, 0x01,   // 0102 LXI D,$0112
+        0xcd, 0x05, 0x00,   // 0105 CALL $0005
+        0x0e, 0x02,         // 0108 MVI C,$02
+        0x1e, 0x21,         // 010a MVI E,'!'
+        0xcd, 0x05, 0x00,   // 010c CALL $0005
+        0xc3, 0x00, 0x00,   // 010f JMP $0000
+        'H', 'I', '$',      // 0112
+    };
+
+    Emulator emulator;
+    cpm::RunResult result = cpm::run(emulator, program);
+    EXPECT_TRUE(result.finished);
+    EXPECT_EQ(result.output, "HI!");
+    EXPECT_EQ(result.instructions, 11);
+    EXPECT_EQ(emulator.status_.sp, cpm::bdosBase);
+}
+
+TEST(CpmTest, StopsAfterMaxCycles) {
+    std::vector<Byte> const loop {0xc3, 0x00, 0x01};    // 0100 JMP $0100
+    Emulator emulator;
+    cpm::RunResult result = cpm::run(emulator, loop, 100);
+    EXPECT_FALSE(result.finished);
+    EXPECT_EQ(result.cycles, 100);
+    EXPECT_EQ(result.instructions, 10);
+}
+
+TEST(CpmTest, ParseGroups) {
+    std::string const output =
+            "8080 instruction exerciser\r\n"
+            "dad <b,d,h,sp>................  PASS! crc is:14474ba6\r\n"
+            "aluop nn......................  ERROR **** crc expected:9e922f9e found:01234567\r\n"
+            "Tests complete";
+    auto groups = cpm::parseGroups(output);
+    ASSERT_EQ(groups.size(), 2);
+    EXPECT_EQ(groups[0].name, "dad <b,d,h,sp>");
+    EXPECT_TRUE(groups[0].passed);
+    EXPECT_EQ(groups[0].detail, "crc is:14474ba6");
+    EXPECT_EQ(groups[1].name, "aluop nn");
+    EXPECT_FALSE(groups[1].passed);
+    EXPECT_EQ(groups[1].detail, "crc expected:9e922f9e found:01234567");
+}
+
+TEST(CpmTest, Tst8080) { runExerciser("TST8080.COM", "CPU IS OPERATIONAL"); }
+
+TEST(CpmTest, Cputest) { runExerciser("CPUTEST.COM", "CPU TESTS OK"); }
+
+TEST(CpmTest, Preliminary8080) { runExerciser("8080PRE.COM", "Preliminary tests complete"); }
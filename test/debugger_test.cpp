@@ -0,0 +1,110 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <emulator.h>
+
+class DebuggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::vector<Byte> const program {
+            0x31, 0x00, 0x30,   // 0000 LXI SP,$3000
+            0x21, 0x00, 0x20,   // 0003 LXI H,$2000
+            0x06, 0x00,         // 0006 MVI B,$00
+            0x04,               // 0008 INR B
+            0x70,               // 0009 MOV M,B
+            0x23,               // 000a INX H
+            0x3a, 0x00, 0x21,   // 000b LDA $2100
+            0xc5,               // 000e PUSH B
+            0xc1,               // 000f POP B
+            0xc3, 0x08, 0x00,   // 0010 JMP $0008
+        };
+        std::copy(program.begin(), program.end(), status.memory.begin());
+    }
+
+    Emulator emulator_;
+    Status& status = emulator_.status_;
+    Debugger& debugger = emulator_.debugger_;
+};
+
+TEST_F(DebuggerTest, Breakpoint) {
+    EXPECT_FALSE(debugger.active());
+    debugger.addBreakpoint(0x000a);
+    EXPECT_TRUE(debugger.active());
+
+    Stop stop = emulator_.run(10000);
+    EXPECT_EQ(stop.reason, StopReason::BREAKPOINT);
+    EXPECT_EQ(stop.pc, 0x000a);
+    EXPECT_EQ(stop.opcode, 0x23);
+    EXPECT_EQ(status.pc, 0x000a);
+    EXPECT_EQ(status.b, 1);
+
+    // Resuming runs the op at the breakpoint and stops at it on the next iteration.
+    stop = emulator_.run(10000);
+    EXPECT_EQ(stop.reason, StopReason::BREAKPOINT);
+    EXPECT_EQ(status.b, 2);
+
+    debugger.removeBreakpoint(0x000a);
+    EXPECT_FALSE(debugger.active());
+    EXPECT_EQ(emulator_.run(1000).reason, StopReason::CYCLE_BUDGET);
+}
+
+TEST_F(DebuggerTest, SlicedRunChecksEverySliceStart) {
+    debugger.addBreakpoint(0x000e);
+    int hits = 0;
+    while (status.b < 10) {
+        // One op per slice, so every op the loop runs starts a slice.
+        Stop const stop = emulator_.run(1);
+        if (stop.reason != StopReason::BREAKPOINT) { continue; }
+        ++hits;
+        EXPECT_EQ(status.pc, 0x000e);
+        EXPECT_EQ(status.b, hits);
+    }
+    EXPECT_EQ(hits, 9);
+}
+
+TEST_F(DebuggerTest, WriteWatchpoint) {
+    debugger.addWatchpoint(0x2003, 2, WATCH_WRITE);
+    Stop stop = emulator_.run(100000);
+    EXPECT_EQ(stop.reason, StopReason::WATCHPOINT);
+    EXPECT_EQ(stop.pc, 0x0009);
+    EXPECT_EQ(stop.address, 0x2003);
+    EXPECT_EQ(status.memory[0x2003], 0x00);     // Stops before the write.
+    EXPECT_EQ(status.memory[0x2002], 0x03);
+}
+
+TEST_F(DebuggerTest, ReadWatchpoint) {
+    debugger.addWatchpoint(0x2100, 1, WATCH_READ);
+    debugger.addWatchpoint(0x2000, 0x100, WATCH_READ);    // MOV M,B only writes there.
+    Stop stop = emulator_.run(100000);
+    EXPECT_EQ(stop.reason, StopReason::WATCHPOINT);
+    EXPECT_EQ(stop.pc, 0x000b);
+    EXPECT_EQ(stop.address, 0x2100);
+}
+
+TEST_F(DebuggerTest, StackWatchpoint) {
+    debugger.addWatchpoint(0x2ffe, 2, WATCH_READ);
+    Stop stop = emulator_.run(100000);
+    EXPECT_EQ(stop.reason, StopReason::WATCHPOINT);
+    EXPECT_EQ(stop.pc, 0x000f);
+    EXPECT_EQ(stop.address, 0x2ffe);
+
+    debugger.clear();
+    debugger.addWatchpoint(0x2fff, 1, WATCH_WRITE);
+    stop = emulator_.run(100000);
+    EXPECT_EQ(stop.reason, StopReason::WATCHPOINT);
+    EXPECT_EQ(stop.pc, 0x000e);
+    EXPECT_EQ(stop.address, 0x2fff);
+}
+
+TEST_F(DebuggerTest, Condition) {
+    int const id = debugger.addCondition([](Status const& s) { return s.b == 5; });
+    Stop stop = emulator_.run(100000);
+    EXPECT_EQ(stop.reason, StopReason::CONDITION);
+    EXPECT_EQ(status.b, 5);
+    EXPECT_EQ(stop.pc, 0x0009);
+
+    debugger.removeCondition(id);
+    EXPECT_FALSE(debugger.active());
+}
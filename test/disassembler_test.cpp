@@ -0,0 +1,117 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <disassembler.h>
+#include <opcodes.h>
+
+class DisassemblerTest : public ::testing::Test {
+protected:
+    std::string line(std::vector<Byte> const& ops, uint16_t pc = 0) {
+        char buffer[Disassembler::maxLineLength];
+        char* out = buffer;
+        bytesInOp = disassembler_.disassembleOp(pc, ops, out);
+        return {buffer, out};
+    }
+
+    Disassembler disassembler_;
+    int bytesInOp {0};
+};
+
+TEST_F(DisassemblerTest, Implied) {
+    EXPECT_EQ(line({0x00}), "0000\tNOP\n");
+    EXPECT_EQ(bytesInOp, 1);
+    EXPECT_EQ(line({0x7e}), "0000\tMOV A,M\n");
+    EXPECT_EQ(line({0xf5}), "0000\tPUSH PSW\n");
+    EXPECT_EQ(line({0xff}), "0000\tRST 7\n");
+}
+
+TEST_F(DisassemblerTest, Immediates) {
+    EXPECT_EQ(line({0x06, 0x10}), "0000\tMVI B,#$10\n");
+    EXPECT_EQ(bytesInOp, 2);
+    EXPECT_EQ(line({0x31, 0x00, 0x24}), "0000\tLXI SP,#$2400\n");
+    EXPECT_EQ(bytesInOp, 3);
+    EXPECT_EQ(line({0xd3, 0x03}), "0000\tOUT #$03\n");
+}
+
+TEST_F(DisassemblerTest, Addresses) {
+    EXPECT_EQ(line({0x00, 0xc3, 0xd4, 0x18}, 1), "0001\tJMP $18d4\n");
+    EXPECT_EQ(line({0xcd, 0xe6, 0x01}), "0000\tCALL $01e6\n");
+    EXPECT_EQ(line({0x32, 0x72, 0x20}), "0000\tSTA $2072\n");
+}
+
+TEST_F(DisassemblerTest, TruncatedOperand) {
+    EXPECT_EQ(line({0xc3}), "0000\tJMP $0000\n");
+    EXPECT_EQ(bytesInOp, 3);
+}
+
+TEST_F(DisassemblerTest, WholeImage) {
+    std::vector<Byte> ops {0x00, 0x3e, 0x01, 0xc3, 0x00, 0x00};
+    EXPECT_EQ(disassembler_.disassemble(ops), "0000\tNOP\n0001\tMVI A,#$01\n0003\tJMP $0000\n");
+}
+
+TEST_F(DisassemblerTest, Bulk) {
+    namespace fs = std::filesystem;
+    fs::path const root = fs::path(::testing::TempDir()) / "disassembler_bulk";
+    fs::remove_all(root);
+    fs::create_directories(root / "images");
+
+    std::vector<std::vector<Byte>> images {{0x00, 0x76}, {0x3e, 0x01}, {0xc3, 0x00, 0x00}};
+    for (size_t i = 0; i < images.size(); ++i) {
+        std::ofstream out(root / "images" / ("image" + std::to_string(i) + ".bin"), std::ios::binary);
+        out.write(reinterpret_cast<char const*>(images[i].data()), images[i].size());
+    }
+
+    auto paths = Disassembler::collectImages({(root / "images").string()});
+    ASSERT_EQ(paths.size(), images.size());
+    BulkReport report = disassembler_.disassembleBulk(paths, (root / "listings").string(), 2);
+    EXPECT_TRUE(report.errors.empty());
+    EXPECT_EQ(report.images, 3);
+    EXPECT_EQ(report.bytes, 7);
+
+    for (size_t i = 0; i < images.size(); ++i) {
+        std::ifstream in(root / "listings" / ("image" + std::to_string(i) + ".bin.asm"));
+        std::stringstream listing;
+        listing << in.rdbuf();
+        EXPECT_EQ(listing.str(), disassembler_.disassemble(images[i]));
+    }
+    fs::remove_all(root);
+}
+
+TEST_F(DisassemblerTest, BulkSameNames) {
+    namespace fs = std::filesystem;
+    fs::path const root = fs::path(::testing::TempDir()) / "disassembler_same_names";
+    fs::remove_all(root);
+    std::vector<std::vector<Byte>> images {{0x00, 0x76}, {0x3e, 0x01}, {0xc3, 0x00, 0x00}};
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < images.size(); ++i) {
+        fs::path const directory = root / ("set" + std::to_string(i));
+        fs::create_directories(directory);
+        std::ofstream out(directory / "rom.bin", std::ios::binary);
+        out.write(reinterpret_cast<char const*>(images[i].data()), images[i].size());
+        paths.push_back((directory / "rom.bin").string());
+    }
+
+    BulkReport report = disassembler_.disassembleBulk(paths, (root / "listings").string(), 3);
+    EXPECT_TRUE(report.errors.empty());
+    for (size_t i = 0; i < images.size(); ++i) {
+        std::string const name = i == 0 ? "rom.bin.asm" : "rom.bin." + std::to_string(i + 1) + ".asm";
+        std::ifstream in(root / "listings" / name);
+        std::stringstream listing;
+        listing << in.rdbuf();
+        EXPECT_EQ(listing.str(), disassembler_.disassemble(images[i])) << name;
+    }
+    fs::remove_all(root);
+}
+
+TEST(OpcodeTable, LengthsMatchOperands) {
+    for (auto const& info: opcodes) {
+        int expected = info.operand == OPERAND_NONE ? 1 : (info.operand == OPERAND_DATA16 || info.operand == OPERAND_ADDRESS ? 3 : 2);
+        EXPECT_EQ(info.length, expected) << info.text;
+        EXPECT_GE(info.cyclesTaken, info.cycles) << info.text;
+    }
+}
@@ -0,0 +1,68 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <flowgraph.h>
+
+// 0000 JMP $0006
+// 0003 data: 0x3e 0x3e 0x3e (would decode as MVI A if read linearly)
+// 0006 CALL $000d
+// 0009 JNZ $0006
+// 000c HLT
+// 000d DCR B
+// 000e RET
+static std::vector<Byte> const program {
+    0xc3, 0x06, 0x00,
+    0x3e, 0x3e, 0x3e,
+    0xcd, 0x0d, 0x00,
+    0xc2, 0x06, 0x00,
+    0x76,
+    0x05,
+    0xc9,
+};
+
+TEST(FlowGraphTest, SkipsDataAfterJump) {
+    auto graph = FlowGraph::analyze(program, {0x0000});
+    EXPECT_EQ(graph.blockAt(0x0003), nullptr);
+    EXPECT_EQ(graph.instructionCount(), 6);
+}
+
+TEST(FlowGraphTest, SplitsBlocksAtBranches) {
+    auto graph = FlowGraph::analyze(program, {0x0000});
+    ASSERT_EQ(graph.blocks().size(), 5);
+
+    auto const* entry = graph.blockAt(0x0000);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->exit, FLOW_JUMP);
+    ASSERT_EQ(entry->successors.size(), 1);
+    EXPECT_EQ(entry->successors[0].target, 0x0006);
+
+    auto const* call = graph.blockAt(0x0006);
+    ASSERT_NE(call, nullptr);
+    ASSERT_EQ(call->successors.size(), 2);
+    EXPECT_EQ(call->successors[0].target, 0x000d);
+    EXPECT_EQ(call->successors[0].kind, EDGE_CALL);
+    EXPECT_EQ(call->successors[1].target, 0x0009);
+    EXPECT_EQ(call->successors[1].kind, EDGE_FALLTHROUGH);
+
+    auto const* halt = graph.blockAt(0x000c);
+    ASSERT_NE(halt, nullptr);
+    EXPECT_TRUE(halt->successors.empty());
+
+    auto const* routine = graph.blockAt(0x000d);
+    ASSERT_NE(routine, nullptr);
+    EXPECT_EQ(routine->last, 0x000e);
+    EXPECT_EQ(routine->exit, FLOW_RET);
+}
+
+TEST(FlowGraphTest, EmitsTextAndDot) {
+    auto graph = FlowGraph::analyze(program, {0x0000});
+    std::string text = graph.toText(program);
+    EXPECT_NE(text.find("block $0000..$0000 entry\n0000\tJMP $0006\n  -> $0006 jump\n"), std::string::npos);
+    EXPECT_EQ(text.find("MVI"), std::string::npos);
+
+    std::string dot = graph.toDot(program);
+    EXPECT_NE(dot.find("b0006 -> b000d [style=dashed];"), std::string::npos);
+    EXPECT_NE(dot.find("b0009 -> b0006;"), std::string::npos);
+}
@@ -0,0 +1,167 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <arpa/inet.h>
+#include <cstdio>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <thread>
+#include <unistd.h>
+#include <emulator.h>
+#include <gdbstub.h>
+
+class GdbStubTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::vector<Byte> const program {
+            0x31, 0x00, 0x30,   // 0000 LXI SP,$3000
+            0x21, 0x00, 0x20,   // 0003 LXI H,$2000
+            0x06, 0x00,         // 0006 MVI B,$00
+            0x04,               // 0008 INR B
+            0x70,               // 0009 MOV M,B
+            0xc3, 0x08, 0x00,   // 000a JMP $0008
+        };
+        std::copy(program.begin(), program.end(), emulator_.status_.memory.begin());
+        server_ = std::thread([this] { stub_.serve(emulator_, sliceCycles_); });
+
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(stub_.port());
+        timeval const timeout {5, 0};   // A missing reply fails the test rather than hanging it.
+        setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof timeout);
+        ASSERT_EQ(connect(fd_, reinterpret_cast<sockaddr*>(&address), sizeof address), 0);
+    }
+
+    void TearDown() override {
+        close(fd_);
+        server_.join();
+    }
+
+    void write(std::string const& bytes) {
+        ASSERT_EQ(::send(fd_, bytes.data(), bytes.size(), 0), (ssize_t) bytes.size());
+    }
+
+    char read() {
+        char c = 0;
+        EXPECT_EQ(recv(fd_, &c, 1, 0), 1);
+        return c;
+    }
+
+    // Sends one packet and returns the payload of the reply, checking the acknowledgement and the
+    // reply's checksum on the way.
+    std::string request(std::string const& payload) {
+        unsigned sum = 0;
+        for (char c: payload) { sum += (unsigned char) c; }
+        char checksum[4];
+        std::snprintf(checksum, sizeof checksum, "#%02x", sum & 0xff);
+        write("$" + payload + checksum);
+        if (acks_) { EXPECT_EQ(read(), '+'); }
+        return reply();
+    }
+
+    std::string reply() {
+        EXPECT_EQ(read(), '$');
+        std::string payload;
+        unsigned sum = 0;
+        for (char c = read(); c != '#' && c != 0; c = read()) {
+            payload += c;
+            sum += (unsigned char) c;
+        }
+        std::string const checksum {read(), read()};
+        EXPECT_EQ(std::stoul(checksum, nullptr, 16), sum & 0xff) << payload;
+        return payload;
+    }
+
+    Emulator emulator_;
+    GdbStub stub_ {0};
+    std::thread server_;
+    int fd_ {-1};
+    bool acks_ {true};
+    uint64_t sliceCycles_ {1000};
+};
+
+// Slices of one loop pass, 22 states: after the setup's slice, every slice starts at INR B.
+class GdbStubSliceTest : public GdbStubTest {
+protected:
+    void SetUp() override {
+        sliceCycles_ = 22;
+        GdbStubTest::SetUp();
+    }
+};
+
+TEST_F(GdbStubTest, RegistersAndMemory) {
+    EXPECT_NE(request("qSupported:swbreak+").find("PacketSize="), std::string::npos);
+    EXPECT_EQ(request("?"), "S05");
+    EXPECT_EQ(request("g"), "020000000000000000000000");  // F has its always-set bit 1
+    EXPECT_EQ(request("m0,3"), "310030");
+    EXPECT_EQ(request(""), "");     // An empty packet is answered, not taken for a disconnect.
+    EXPECT_EQ(request("?"), "S05");
+
+    EXPECT_EQ(request("P3=3412"), "OK");
+    EXPECT_EQ(emulator_.status_.h, 0x12);
+    EXPECT_EQ(emulator_.status_.l, 0x34);
+    EXPECT_EQ(request("p3"), "3412");
+
+    EXPECT_EQ(request("M4000,2:abcd"), "OK");
+    EXPECT_EQ(emulator_.status_.memory[0x4000], 0xab);
+    EXPECT_EQ(emulator_.status_.memory[0x4001], 0xcd);
+    EXPECT_EQ(request("vMustReplyEmpty"), "");
+
+    write("$k#6b");
+    EXPECT_EQ(read(), '+');
+}
+
+TEST_F(GdbStubTest, StepAndBreakpoint) {
+    EXPECT_EQ(request("QStartNoAckMode"), "OK");
+    acks_ = false;
+
+    EXPECT_EQ(request("s"), "S05");
+    EXPECT_EQ(request("g").substr(16), "00300300");   // SP $3000, PC $0003
+
+    EXPECT_EQ(request("Z0,9,1"), "OK");
+    EXPECT_EQ(request("c"), "S05");
+    EXPECT_EQ(emulator_.status_.pc, 0x0009);
+    EXPECT_EQ(emulator_.status_.b, 1);
+    EXPECT_EQ(request("c"), "S05");
+    EXPECT_EQ(emulator_.status_.b, 2);
+    EXPECT_EQ(request("z0,9,1"), "OK");
+
+    EXPECT_EQ(request("Z2,2000,1"), "OK");
+    EXPECT_EQ(request("c"), "T05watch:2000;");
+    EXPECT_EQ(emulator_.status_.b, 3);
+    EXPECT_EQ(request("z2,2000,1"), "OK");
+
+    EXPECT_EQ(request("M9,1:7e"), "OK");    // MOV A,M: the loop now reads $2000.
+    EXPECT_EQ(request("Z3,2000,1"), "OK");
+    EXPECT_EQ(request("c"), "T05rwatch:2000;");
+    EXPECT_EQ(request("z3,2000,1"), "OK");
+    EXPECT_EQ(request("Z4,2000,1"), "OK");
+    EXPECT_EQ(request("c"), "T05awatch:2000;");
+    EXPECT_EQ(request("z4,2000,1"), "OK");
+
+    EXPECT_EQ(request("D"), "OK");
+}
+
+TEST_F(GdbStubTest, InterruptAndDisconnect) {
+    write("$c#63");
+    EXPECT_EQ(read(), '+');
+    write("\x03");
+    EXPECT_EQ(reply(), "S02");
+    EXPECT_NE(emulator_.status_.b, 0);
+    // Closing the connection in TearDown ends serve().
+}
+
+TEST_F(GdbStubSliceTest, BreakpointOnSliceStart) {
+    EXPECT_EQ(request("Z0,8,1"), "OK");
+    for (int pass = 0; pass < 5; ++pass) {
+        EXPECT_EQ(request("c"), "S05");
+        EXPECT_EQ(emulator_.status_.pc, 0x0008);
+        EXPECT_EQ(emulator_.status_.b, pass);
+    }
+    EXPECT_EQ(request("D"), "OK");
+}
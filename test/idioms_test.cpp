@@ -0,0 +1,155 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <emulator.h>
+#include <profiler.h>
+#include <workloads.h>
+
+namespace {
+
+using Program = std::vector<std::pair<uint16_t, std::vector<Byte>>>;
+
+void load(Emulator& emulator, Program const& program, uint16_t start) {
+    Status& status = emulator.status_;
+    // Recognizable garbage, so copies and fills of it show.
+    for (size_t i = 0; i < status.memory.size(); ++i) { status.memory[i] = i * 7 + (i >> 8); }
+    for (auto const& [address, bytes]: program) {
+        std::copy(bytes.begin(), bytes.end(), status.memory.begin() + address);
+    }
+    status.pc = start;
+}
+
+void expectSameState(Emulator const& fast, Emulator const& slow) {
+    Status const& f = fast.status_;
+    Status const& s = slow.status_;
+    EXPECT_EQ(f.pc, s.pc);
+    EXPECT_EQ(f.cycles, s.cycles);
+    EXPECT_EQ(fast.psw(), slow.psw());
+    EXPECT_EQ(f.a, s.a);
+    EXPECT_EQ(f.b << 8 | f.c, s.b << 8 | s.c);
+    EXPECT_EQ(f.d << 8 | f.e, s.d << 8 | s.e);
+    EXPECT_EQ(f.h << 8 | f.l, s.h << 8 | s.l);
+    EXPECT_EQ(f.sp, s.sp);
+    EXPECT_TRUE(f.memory == s.memory);
+}
+
+// Runs program to its HLT with and without idioms in slices of the given number of states,
+// comparing the whole machine after each. Returns the iterations the idioms ran.
+uint64_t runBoth(Program const& program, uint64_t slice, uint16_t start = 0) {
+    Emulator fast;
+    Emulator slow;
+    fast.idioms_.setEnabled(true);
+    load(fast, program, start);
+    load(slow, program, start);
+    for (int i = 0; i < 1000000; ++i) {
+        Stop const f = fast.run(slice);
+        Stop const s = slow.run(slice);
+        EXPECT_EQ(f.reason, s.reason);
+        expectSameState(fast, slow);
+        if (::testing::Test::HasFailure() || s.reason != StopReason::CYCLE_BUDGET) { break; }
+    }
+    EXPECT_EQ(slow.lastStop().reason, StopReason::HALTED);
+    return fast.idioms_.iterations();
+}
+
+// LXI D,source; LXI H,destination; LXI B,count; then the loop at $0100 and HLT.
+Program copyLoop(uint16_t source, uint16_t destination, uint16_t count, std::vector<Byte> loop) {
+    loop.push_back(0x76);
+    return {{0x0000, {0x11, static_cast<Byte>(source), static_cast<Byte>(source >> 8),
+                      0x21, static_cast<Byte>(destination), static_cast<Byte>(destination >> 8),
+                      0x01, static_cast<Byte>(count), static_cast<Byte>(count >> 8),
+                      0xc3, 0x00, 0x01}},
+            {0x0100, loop}};
+}
+
+std::vector<Byte> const copy8 {0x1a, 0x77, 0x13, 0x23, 0x0d, 0xc2, 0x00, 0x01};
+std::vector<Byte> const copy16 {0x1a, 0x77, 0x23, 0x13, 0x0b, 0x79, 0xb0, 0xc2, 0x00, 0x01};
+
+}
+
+TEST(IdiomsTest, Recognizes) {
+    Emulator emulator;
+    load(emulator, copyLoop(0, 0, 0, copy8), 0);
+    IdiomMatch const match = Idioms::recognize(emulator.status_.memory, 0x0100);
+    EXPECT_EQ(match.idiom, Idiom::COPY8);
+    EXPECT_EQ(match.length, 8);
+    EXPECT_EQ(match.cycles, 7 + 7 + 5 + 5 + 5 + 10);
+    EXPECT_EQ(match.counter, 0x0d);
+    EXPECT_EQ(Idioms::recognize(emulator.status_.memory, 0x0101).idiom, Idiom::NONE);
+
+    emulator.status_.memory[0x0106] = 0x01;     // JNZ somewhere else.
+    EXPECT_EQ(Idioms::recognize(emulator.status_.memory, 0x0100).idiom, Idiom::NONE);
+    load(emulator, copyLoop(0, 0, 0, copy16), 0);
+    EXPECT_EQ(Idioms::recognize(emulator.status_.memory, 0x0100).idiom, Idiom::COPY16);
+}
+
+TEST(IdiomsTest, Copy) {
+    EXPECT_EQ(runBoth(copyLoop(0x2000, 0x3000, 0x0040, copy8), 1000000), 0x3f);
+    EXPECT_EQ(runBoth(copyLoop(0x2000, 0x3000, 0x0000, copy8), 1000000), 0xff);    // 256 times.
+    EXPECT_GT(runBoth(copyLoop(0x2000, 0x3000, 0x0000, copy8), 97), 0u);
+    EXPECT_EQ(runBoth(copyLoop(0x2000, 0x3000, 0x1234, copy16), 1000000), 0x1233);
+    EXPECT_GT(runBoth(copyLoop(0x3000, 0x2000, 0x1234, copy16), 1000), 0u);
+}
+
+TEST(IdiomsTest, OverlappingAndWrappingCopies) {
+    EXPECT_GT(runBoth(copyLoop(0x2000, 0x2001, 0x0300, copy16), 1000000), 0u);  // Smears the first byte.
+    EXPECT_GT(runBoth(copyLoop(0x2001, 0x2000, 0x0300, copy16), 1000000), 0u);
+    EXPECT_GT(runBoth(copyLoop(0xfff0, 0xfffa, 0x0020, copy8), 1000000), 0u);  // Over the code that ran.
+    EXPECT_GT(runBoth(copyLoop(0xfff0, 0x0000, 0x0040, copy8), 1000000), 0u);
+}
+
+TEST(IdiomsTest, StandardWorkload) {
+    Workload const& memcpy = standardWorkloads()[0];
+    EXPECT_EQ(runBoth({{0x0000, memcpy.program}}, 1000000), 0x3ff);
+    EXPECT_GT(runBoth({{0x0000, memcpy.program}}, 333), 0u);
+    EXPECT_EQ(runBoth({{0x0000, memcpy.program}}, 1), 0u);
+}
+
+TEST(IdiomsTest, Fill) {
+    Program const fill8 {
+        {0x0000, {0x21, 0xf0, 0xff, 0x3e, 0x5a, 0x1e, 0x30, 0xc3, 0x00, 0x01}},     // HL=$fff0, A=$5a, E=$30
+        {0x0100, {0x77, 0x23, 0x1d, 0xc2, 0x00, 0x01, 0x76}},
+    };
+    EXPECT_EQ(runBoth(fill8, 1000000), 0x2f);
+    EXPECT_GT(runBoth(fill8, 50), 0u);
+
+    // Space Invaders' ClearScreen.
+    Program const clear {{0x14cb, {0x21, 0x00, 0x24, 0x36, 0x00, 0x23, 0x7c, 0xfe, 0x40, 0xc2, 0xce, 0x14, 0x76}}};
+    EXPECT_EQ(runBoth(clear, 1000000, 0x14cb), 0x1bff);
+    EXPECT_GT(runBoth(clear, 16667, 0x14cb), 0u);
+
+    // Round from $4100 past $ffff up to $4000, around the code.
+    Program const around {{0x4080, {0x21, 0x00, 0x41, 0x36, 0xe7, 0x23, 0x7c, 0xfe, 0x40, 0xc2, 0x83, 0x40, 0x76}}};
+    EXPECT_EQ(runBoth(around, 10000000, 0x4080), 0xfeff);
+}
+
+TEST(IdiomsTest, LeavesItsOwnCodeToTheInterpreter) {
+    // Fills over the loop itself with NOPs, so it runs on into whatever follows.
+    Program const program {
+        {0x0000, {0x21, 0xf8, 0x00, 0xaf, 0x0e, 0x20, 0xc3, 0x00, 0x01}},     // HL=$00f8, A=0, C=$20
+        {0x0100, {0x77, 0x23, 0x0d, 0xc2, 0x00, 0x01, 0x00, 0x76}},
+    };
+    EXPECT_EQ(runBoth(program, 1000000), 0u);
+}
+
+TEST(IdiomsTest, OffWhileDebuggingOrProfiling) {
+    Workload const& memcpy = standardWorkloads()[0];
+    Emulator emulator;
+    emulator.idioms_.setEnabled(true);
+    load(emulator, {{0x0000, memcpy.program}}, 0);
+    emulator.debugger_.addBreakpoint(0xe000);
+    EXPECT_EQ(emulator.run(1000000).reason, StopReason::HALTED);
+    EXPECT_EQ(emulator.idioms_.loops(), 0u);
+
+    emulator.debugger_.clear();
+    emulator.status_.pc = 0;
+    Profiler profiler;
+    EXPECT_EQ(emulator.run(1000000, profiler).reason, StopReason::HALTED);
+    EXPECT_EQ(emulator.idioms_.loops(), 0u);
+
+    emulator.status_.pc = 0;
+    EXPECT_EQ(emulator.run(1000000).reason, StopReason::HALTED);
+    EXPECT_EQ(emulator.idioms_.loops(), 1u);
+}
@@ -0,0 +1,40 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <sstream>
+#include <inputscript.h>
+
+TEST(InputScriptTest, AppliesChangesByFrame) {
+    std::istringstream text("# insert a coin, then start\n"
+                            "3 coin down\n"
+                            "\n"
+                            "5 p1_start down   # held for a frame\n"
+                            "4 coin up\n"
+                            "6 p1_start up\n");
+    InputScript script = InputScript::parse(text);
+    EXPECT_EQ(script.size(), 4u);
+    Invaders machine;
+    script.apply(2, machine);
+    EXPECT_EQ(machine.in(1, 0), 0x08);
+    script.apply(3, machine);
+    EXPECT_EQ(machine.in(1, 0), 0x09);
+    script.apply(5, machine);           // Frame 4's release is still made.
+    EXPECT_EQ(machine.in(1, 0), 0x0c);
+    script.apply(100, machine);
+    EXPECT_EQ(machine.in(1, 0), 0x08);
+}
+
+TEST(InputScriptTest, Errors) {
+    for (char const* bad: {"x coin down\n", "3 quarter down\n", "3 coin pressed\n", "3 coin down now\n", "3 coin\n"}) {
+        std::istringstream text(std::string("1 tilt up\n") + bad);
+        try {
+            InputScript::parse(text, "keys");
+            ADD_FAILURE() << bad;
+        } catch (InputScriptError const& e) {
+            EXPECT_EQ(std::string(e.what()).rfind("keys:2: ", 0), 0u) << e.what();
+        }
+    }
+    EXPECT_THROW(InputScript::load(::testing::TempDir() + "inputscript_missing.txt"), InputScriptError);
+}
@@ -0,0 +1,140 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <emulator.h>
+#include <invaders.h>
+
+class InvadersTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::vector<std::pair<uint16_t, std::vector<Byte>>> const program {
+            {0x0008, {0xc3, 0x20, 0x00}},   // RST 1: JMP $0020
+            {0x0010, {0xc3, 0x30, 0x00}},   // RST 2: JMP $0030
+            {0x0020, {
+                0xf5,               // 0020 PUSH PSW
+                0x3a, 0x10, 0x20,   // 0021 LDA $2010
+                0x3c,               // 0024 INR A
+                0x32, 0x10, 0x20,   // 0025 STA $2010
+                0xf1,               // 0028 POP PSW
+                0xfb,               // 0029 EI
+                0xc9,               // 002a RET
+            }},
+            {0x0030, {
+                0xf5,               // 0030 PUSH PSW
+                0x3a, 0x11, 0x20,   // 0031 LDA $2011
+                0x3c,               // 0034 INR A
+                0x32, 0x11, 0x20,   // 0035 STA $2011
+                0xf1,               // 0038 POP PSW
+                0xfb,               // 0039 EI
+                0xc9,               // 003a RET
+            }},
+            {0x0040, {
+                0x31, 0x00, 0x24,   // 0040 LXI SP,$2400
+                0xfb,               // 0043 EI
+                0xdb, 0x01,         // 0044 IN 1
+                0x32, 0x01, 0x20,   // 0046 STA $2001
+                0xdb, 0x02,         // 0049 IN 2
+                0x32, 0x02, 0x20,   // 004b STA $2002
+                0xc3, 0x44, 0x00,   // 004e JMP $0044
+            }},
+        };
+        for (auto const& [address, bytes]: program) {
+            std::copy(bytes.begin(), bytes.end(), status.memory.begin() + address);
+        }
+        status.pc = 0x0040;
+        machine_.attach(emulator_);
+    }
+
+    Emulator emulator_;
+    Status& status = emulator_.status_;
+    Invaders machine_;
+};
+
+TEST_F(InvadersTest, InterruptsTwicePerFrame) {
+    for (int frame = 0; frame < 10; ++frame) {
+        EXPECT_EQ(machine_.runFrame(emulator_).reason, StopReason::CYCLE_BUDGET);
+    }
+    EXPECT_EQ(status.memory[0x2010], 10);
+    EXPECT_EQ(status.memory[0x2011], 9);     // The last one is pending, its handler yet to run.
+    EXPECT_EQ(Invaders::frame(status.cycles), 10u);
+}
+
+TEST_F(InvadersTest, InterruptsWaitForEi) {
+    status.is_interrupt_enabled = false;
+    EXPECT_FALSE(emulator_.interrupt(1));
+    EXPECT_EQ(status.pc, 0x0040);
+
+    status.is_interrupt_enabled = true;
+    uint64_t const cycles = status.cycles;
+    EXPECT_TRUE(emulator_.interrupt(1));
+    EXPECT_EQ(status.pc, 0x0008);
+    EXPECT_EQ(status.sp, 0xfffe);
+    EXPECT_EQ(status.memory[0xfffe], 0x40);
+    EXPECT_EQ(status.cycles, cycles + 11);
+    EXPECT_FALSE(status.is_interrupt_enabled);
+}
+
+TEST_F(InvadersTest, Inputs) {
+    machine_.runFrame(emulator_);
+    EXPECT_EQ(status.memory[0x2001], 0x08);
+    EXPECT_EQ(status.memory[0x2002], 0x00);
+
+    machine_.setInput(Invaders::COIN, true);
+    machine_.setInput(Invaders::P1_FIRE, true);
+    machine_.setInput(Invaders::P2_LEFT, true);
+    machine_.setShips(5);
+    machine_.runFrame(emulator_);
+    EXPECT_EQ(status.memory[0x2001], 0x19);
+    EXPECT_EQ(status.memory[0x2002], 0x22);
+
+    machine_.setInput(Invaders::COIN, false);
+    EXPECT_EQ(machine_.in(1, 0), 0x18);
+    EXPECT_EQ(machine_.in(0, 0), 0x0e);
+}
+
+TEST_F(InvadersTest, FrameResumesAfterBreakpoint) {
+    emulator_.debugger_.addBreakpoint(0x0030);
+    EXPECT_EQ(machine_.runFrame(emulator_).reason, StopReason::CYCLE_BUDGET);
+    EXPECT_EQ(status.memory[0x2010], 1);
+
+    // The end of frame interrupt from the first frame runs its handler early in the second.
+    Stop const stop = machine_.runFrame(emulator_);
+    EXPECT_EQ(stop.reason, StopReason::BREAKPOINT);
+    EXPECT_EQ(Invaders::frame(status.cycles), 1u);
+    EXPECT_EQ(status.memory[0x2011], 0);
+
+    emulator_.debugger_.clear();
+    EXPECT_EQ(machine_.runFrame(emulator_).reason, StopReason::CYCLE_BUDGET);
+    EXPECT_EQ(Invaders::frame(status.cycles), 2u);
+    EXPECT_EQ(status.memory[0x2010], 2);
+    EXPECT_EQ(status.memory[0x2011], 1);
+}
+
+TEST_F(InvadersTest, ShiftRegister) {
+    ShiftRegister& shifter = machine_.shiftRegister();
+    EXPECT_EQ(emulator_.shiftRegister(), &shifter);
+    std::vector<Byte> const program {
+        0x3e, 0xa5,         // 0100 MVI A,$a5
+        0xd3, 0x04,         // 0102 OUT 4
+        0x3e, 0x3c,         // 0104 MVI A,$3c
+        0xd3, 0x04,         // 0106 OUT 4
+        0x3e, 0x0b,         // 0108 MVI A,$0b
+        0xd3, 0x02,         // 010a OUT 2
+        0xdb, 0x03,         // 010c IN 3
+    };
+    std::copy(program.begin(), program.end(), status.memory.begin() + 0x100);
+    status.pc = 0x0100;
+    for (int i = 0; i < 7; ++i) { emulator_.emulateOp(); }
+    EXPECT_EQ(shifter.value, 0x3ca5);
+    EXPECT_EQ(shifter.offset, 3);
+    EXPECT_EQ(status.a, 0xe5);      // $3ca5 << 3 = $e528, top byte.
+
+    // Through the generic port interface, as without attach().
+    machine_.out(ShiftRegister::dataPort, 0xff, 0);
+    machine_.out(ShiftRegister::offsetPort, 0, 0);
+    EXPECT_EQ(machine_.in(ShiftRegister::resultPort, 0), 0xff);
+    machine_.out(ShiftRegister::offsetPort, 7, 0);
+    EXPECT_EQ(machine_.in(ShiftRegister::resultPort, 0), 0x9e);   // $ff3c << 7 = $9e00.
+}
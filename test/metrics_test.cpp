@@ -0,0 +1,140 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <thread>
+#include <emulator.h>
+#include <invaders.h>
+#include <metrics.h>
+#include <workloads.h>
+
+TEST(MetricsTest, CounterAddsUpEveryThread) {
+    Counter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 20; ++t) {      // More threads than slots, so some share one.
+        threads.emplace_back([&counter] {
+            for (int i = 0; i < 10000; ++i) { counter.add(); }
+        });
+    }
+    for (auto& thread: threads) { thread.join(); }
+    counter.add(5);
+    EXPECT_EQ(counter.value(), 200005u);
+}
+
+TEST(MetricsTest, HistogramBuckets) {
+    Histogram histogram({5, 1, 2});
+    for (double value: {0.5, 1.0, 1.5, 7.0}) { histogram.observe(value); }
+    EXPECT_EQ(histogram.bounds(), (std::vector<double> {1, 2, 5}));
+    EXPECT_EQ(histogram.counts(), (std::vector<uint64_t> {2, 1, 0, 1}));
+    EXPECT_EQ(histogram.count(), 4u);
+    EXPECT_DOUBLE_EQ(histogram.sum(), 10.0);
+}
+
+TEST(MetricsTest, Registry) {
+    Metrics metrics;
+    Counter& counter = metrics.counter("ops_total", "Ops.", "instance=\"0\"");
+    EXPECT_EQ(&metrics.counter("ops_total", "Ops.", "instance=\"0\""), &counter);
+    EXPECT_NE(&metrics.counter("ops_total", "Ops.", "instance=\"1\""), &counter);
+    EXPECT_THROW(metrics.gauge("ops_total", "Ops.", "instance=\"0\""), MetricsError);
+}
+
+TEST(MetricsTest, PrometheusText) {
+    Metrics metrics;
+    metrics.counter("ops_total", "Ops run.", "instance=\"0\"").add(3);
+    metrics.gauge("speed", "Target.").set(2.5);
+    metrics.counter("ops_total", "Ops run.", "instance=\"1\"").add(4);
+    Histogram& histogram = metrics.histogram("latency", "Lateness.", {1, 10}, "instance=\"0\"");
+    histogram.observe(0);
+    histogram.observe(4);
+    histogram.observe(40);
+    EXPECT_EQ(metrics.prometheus(),
+              "# HELP ops_total Ops run.\n"
+              "# TYPE ops_total counter\n"
+              "ops_total{instance=\"0\"} 3\n"
+              "ops_total{instance=\"1\"} 4\n"
+              "# HELP speed Target.\n"
+              "# TYPE speed gauge\n"
+              "speed 2.5\n"
+              "# HELP latency Lateness.\n"
+              "# TYPE latency histogram\n"
+              "latency_bucket{instance=\"0\",le=\"1\"} 1\n"
+              "latency_bucket{instance=\"0\",le=\"10\"} 2\n"
+              "latency_bucket{instance=\"0\",le=\"+Inf\"} 3\n"
+              "latency_sum{instance=\"0\"} 44\n"
+              "latency_count{instance=\"0\"} 3\n");
+}
+
+TEST(MetricsTest, NonFiniteValues) {
+    Metrics metrics;
+    metrics.gauge("g", "G.", "v=\"nan\"").set(std::nan(""));
+    metrics.gauge("g", "G.", "v=\"inf\"").set(INFINITY);
+    metrics.gauge("g", "G.", "v=\"-inf\"").set(-INFINITY);
+    metrics.histogram("h", "H.", {1}).observe(INFINITY);
+    EXPECT_EQ(metrics.prometheus(),
+              "# HELP g G.\n"
+              "# TYPE g gauge\n"
+              "g{v=\"nan\"} NaN\n"
+              "g{v=\"inf\"} +Inf\n"
+              "g{v=\"-inf\"} -Inf\n"
+              "# HELP h H.\n"
+              "# TYPE h histogram\n"
+              "h_bucket{le=\"1\"} 0\n"
+              "h_bucket{le=\"+Inf\"} 1\n"
+              "h_sum +Inf\n"
+              "h_count 1\n");
+}
+
+TEST(MetricsTest, EmulatorCountsEveryOpRun) {
+    for (auto const& workload: standardWorkloads()) {
+        Emulator reference;
+        uint64_t const expected = runWorkload(reference, workload) + 1;     // With the HLT.
+        for (int mode = 0; mode < 4; ++mode) {
+            Emulator emulator;
+            emulator.idioms_.setEnabled(mode & 1);
+            emulator.setFusion(mode & 2);
+            std::copy(workload.program.begin(), workload.program.end(), emulator.status_.memory.begin());
+            while (emulator.run(997).reason == StopReason::CYCLE_BUDGET) {}
+            EXPECT_EQ(emulator.ops(), expected) << workload.name << " mode " << mode;
+        }
+    }
+}
+
+TEST(MetricsTest, InstanceMetrics) {
+    Metrics metrics;
+    InstanceMetrics instance(metrics, "7", Invaders::clockHz);
+    Emulator emulator;
+    Invaders machine;
+    machine.attach(emulator);
+    machine.setMetrics(&instance);
+    std::vector<Byte> const program {0xfb, 0xc3, 0x00, 0x00, 0, 0, 0, 0, 0xfb, 0xc9, 0, 0, 0, 0, 0, 0, 0xfb, 0xc9};
+    std::copy(program.begin(), program.end(), emulator.status_.memory.begin());
+    for (int frame = 0; frame < 10; ++frame) {
+        machine.runFrame(emulator);
+        instance.recordFrame(emulator, 0.001);
+    }
+    // DI in the loop and NOPs for the handlers' EIs: every interrupt from now on is dropped.
+    emulator.status_.memory[0x00] = 0xf3;
+    emulator.status_.memory[0x08] = 0x00;
+    emulator.status_.memory[0x10] = 0x00;
+    for (int frame = 0; frame < 5; ++frame) {
+        machine.runFrame(emulator);
+        instance.recordFrame(emulator, 0.001);
+    }
+
+    std::string const text = metrics.prometheus();
+    auto value = [&text](std::string const& series) {
+        size_t const at = text.find(series + ' ');
+        return at == std::string::npos ? std::string("missing") : text.substr(at + series.size() + 1, text.find('\n', at) - at - series.size() - 1);
+    };
+    EXPECT_EQ(value("cpu8080_instructions_total{instance=\"7\"}"), std::to_string(emulator.ops()));
+    EXPECT_EQ(value("cpu8080_cycles_total{instance=\"7\"}"), std::to_string(emulator.status_.cycles));
+    EXPECT_EQ(value("cpu8080_target_cycles_per_second{instance=\"7\"}"), "2000000");
+    EXPECT_EQ(value("cpu8080_frame_seconds_count{instance=\"7\"}"), "15");
+    // No op the loop or handlers run takes over 10 states, so none is taken any later.
+    EXPECT_EQ(value("cpu8080_interrupt_latency_states_bucket{instance=\"7\",le=\"10\"}"), "20");
+    EXPECT_EQ(value("cpu8080_interrupt_latency_states_count{instance=\"7\"}"), "20");
+    EXPECT_EQ(value("cpu8080_interrupts_dropped_total{instance=\"7\"}"), "10");
+    EXPECT_EQ(value("cpu8080_unimplemented_opcodes_total{instance=\"7\"}"), "0");
+}
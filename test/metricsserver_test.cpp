@@ -0,0 +1,78 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <arpa/inet.h>
+#include <cstdio>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <metricsserver.h>
+
+namespace {
+
+// Sends request over a fresh connection to address and returns everything until the server closes it.
+std::string exchange(int family, sockaddr const* address, socklen_t length, std::string const& request) {
+    int const fd = socket(family, SOCK_STREAM, 0);
+    timeval const timeout {5, 0};   // A missing reply fails the test rather than hanging it.
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof timeout);
+    EXPECT_EQ(connect(fd, address, length), 0);
+    send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+    std::string reply;
+    char buffer[4096];
+    for (ssize_t count; (count = recv(fd, buffer, sizeof buffer, 0)) > 0;) { reply.append(buffer, count); }
+    close(fd);
+    return reply;
+}
+
+std::string get(uint16_t port, std::string const& request) {
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    return exchange(AF_INET, reinterpret_cast<sockaddr*>(&address), sizeof address, request);
+}
+
+}
+
+TEST(MetricsServerTest, ServesPrometheusText) {
+    Metrics metrics;
+    Counter& counter = metrics.counter("cpu8080_instructions_total", "Ops.", "instance=\"0\"");
+    MetricsServer server(metrics, 0);
+    ASSERT_NE(server.port(), 0);
+
+    counter.add(42);
+    std::string const reply = get(server.port(), "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    EXPECT_EQ(reply.rfind("HTTP/1.1 200 OK\r\n", 0), 0u) << reply;
+    EXPECT_NE(reply.find("Content-Type: text/plain; version=0.0.4\r\n"), std::string::npos);
+    std::string const body = metrics.prometheus();
+    EXPECT_NE(reply.find("Content-Length: " + std::to_string(body.size()) + "\r\n"), std::string::npos);
+    EXPECT_EQ(reply.substr(reply.find("\r\n\r\n") + 4), body);
+    EXPECT_NE(body.find("cpu8080_instructions_total{instance=\"0\"} 42\n"), std::string::npos);
+
+    counter.add();
+    EXPECT_NE(get(server.port(), "GET / HTTP/1.0\r\n\r\n").find("} 43\n"), std::string::npos);
+    EXPECT_EQ(get(server.port(), "GET /other HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 404", 0), 0u);
+    EXPECT_EQ(get(server.port(), "POST /metrics HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 405", 0), 0u);
+}
+
+TEST(MetricsServerTest, UnixSocket) {
+    char path[] = "/tmp/cpu8080-metrics-XXXXXX";
+    ASSERT_NE(mkdtemp(path), nullptr);
+    std::string const socketPath = std::string(path) + "/metrics.sock";
+    Metrics metrics;
+    metrics.gauge("speed", "Target.").set(2);
+    {
+        MetricsServer server(metrics, socketPath);
+        sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+        std::snprintf(address.sun_path, sizeof address.sun_path, "%s", socketPath.c_str());
+        std::string const reply = exchange(AF_UNIX, reinterpret_cast<sockaddr*>(&address), sizeof address, "GET /metrics HTTP/1.1\r\n\r\n");
+        EXPECT_NE(reply.find("\r\n\r\n# HELP speed Target.\n# TYPE speed gauge\nspeed 2\n"), std::string::npos) << reply;
+    }
+    EXPECT_NE(access(socketPath.c_str(), F_OK), 0);
+    rmdir(path);
+}
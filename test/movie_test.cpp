@@ -0,0 +1,143 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <emulator.h>
+#include <invaders.h>
+#include <movie.h>
+
+class MovieTest : public ::testing::Test {
+protected:
+    // Sums every IN 1 into $2000 and keeps the last IN 2 at $2002, so the end state depends on
+    // every value read.
+    static void load(Emulator& emulator) {
+        std::vector<Byte> const program {
+            0x31, 0x00, 0x24,   // 0000 LXI SP,$2400
+            0xf3,               // 0003 DI
+            0xdb, 0x01,         // 0004 IN 1
+            0x47,               // 0006 MOV B,A
+            0x3a, 0x00, 0x20,   // 0007 LDA $2000
+            0x80,               // 000a ADD B
+            0x32, 0x00, 0x20,   // 000b STA $2000
+            0xdb, 0x02,         // 000e IN 2
+            0x32, 0x02, 0x20,   // 0010 STA $2002
+            0xc3, 0x04, 0x00,   // 0013 JMP $0004
+        };
+        std::copy(program.begin(), program.end(), emulator.status_.memory.begin());
+    }
+
+    // Plays 120 frames of fire button presses and a coin on the machine.
+    static Movie record(std::bitset<256> ports = std::bitset<256>().set()) {
+        Emulator emulator;
+        load(emulator);
+        Invaders machine;
+        MovieRecorder recorder(machine, ports);
+        emulator.setPorts(&recorder);
+        emulator.setShiftRegister(&machine.shiftRegister());
+        for (int frame = 0; frame < 120; ++frame) {
+            machine.setInput(Invaders::COIN, frame == 3);
+            machine.setInput(Invaders::P1_FIRE, frame / 7 % 2);
+            machine.setInput(Invaders::P2_RIGHT, frame > 100);
+            machine.runFrame(emulator);
+        }
+        return recorder.finish(emulator);
+    }
+
+    static uint64_t replay(Movie const& movie) {
+        Emulator emulator;
+        load(emulator);
+        Invaders machine;
+        MoviePlayer player(movie, machine);
+        emulator.setPorts(&player);
+        emulator.setShiftRegister(&machine.shiftRegister());
+        while (emulator.status_.cycles < movie.endCycles) { machine.runFrame(emulator); }
+        return stateHash(emulator);
+    }
+
+    std::string path(std::string const& name) {
+        files_.push_back(::testing::TempDir() + name);
+        return files_.back();
+    }
+
+    void TearDown() override {
+        for (auto const& f: files_) { std::remove(f.c_str()); }
+    }
+
+    std::vector<std::string> files_;
+};
+
+TEST_F(MovieTest, ReplaysBitForBit) {
+    Movie const movie = record();
+    EXPECT_EQ(movie.endCycles / Invaders::cyclesPerFrame, 120u);
+    // Two initial reads plus the input changes, out of over 100,000 reads.
+    EXPECT_LT(movie.reads.size(), 30u);
+
+    EXPECT_EQ(replay(movie), movie.endHash);
+
+    Movie idle = movie;
+    idle.reads.clear();
+    EXPECT_NE(replay(idle), movie.endHash);
+}
+
+TEST_F(MovieTest, SavesAndLoads) {
+    Movie const movie = record();
+    std::string const filename = path("movie_session.mov");
+    movie.save(filename);
+    EXPECT_LT(std::ifstream(filename, std::ios::binary | std::ios::ate).tellg(), 8 + 32 + 24 + 30 * 5);
+
+    Movie const loaded = Movie::load(filename);
+    EXPECT_EQ(loaded.ports, movie.ports);
+    EXPECT_EQ(loaded.endCycles, movie.endCycles);
+    EXPECT_EQ(loaded.endHash, movie.endHash);
+    ASSERT_EQ(loaded.reads.size(), movie.reads.size());
+    for (size_t i = 0; i < movie.reads.size(); ++i) {
+        EXPECT_EQ(loaded.reads[i].cycles, movie.reads[i].cycles);
+        EXPECT_EQ(loaded.reads[i].port, movie.reads[i].port);
+        EXPECT_EQ(loaded.reads[i].value, movie.reads[i].value);
+    }
+    EXPECT_EQ(replay(loaded), movie.endHash);
+}
+
+TEST_F(MovieTest, RecordsOnlyChosenPorts) {
+    std::bitset<256> ports;
+    ports.set(1);
+    Movie const movie = record(ports);
+    for (auto const& read: movie.reads) { EXPECT_EQ(read.port, 1); }
+    // Port 2 comes from the idle machine on replay, which never had P2_RIGHT pressed.
+    EXPECT_NE(replay(movie), movie.endHash);
+}
+
+TEST_F(MovieTest, PlayerAnswersByCycle) {
+    Movie movie;
+    movie.ports.set(1);
+    movie.reads = {{100, 1, 0x08}, {200, 1, 0x18}, {300, 1, 0x09}};
+    Invaders machine;
+    MoviePlayer player(movie, machine);
+    EXPECT_EQ(player.in(1, 250), 0x18);
+    EXPECT_EQ(player.in(1, 1000), 0x09);
+    EXPECT_EQ(player.in(1, 150), 0x08);     // Going back, as Timeline::seek does.
+    EXPECT_EQ(player.in(1, 200), 0x18);
+    EXPECT_EQ(player.in(1, 50), 0x08);      // Before the first read: the device's value.
+    EXPECT_EQ(player.in(0, 250), 0x0e);     // Not recorded.
+}
+
+TEST_F(MovieTest, LoadErrors) {
+    EXPECT_THROW(Movie::load(path("movie_missing.mov")), MovieError);
+
+    std::string const garbage = path("movie_garbage.mov");
+    std::ofstream(garbage) << "not a movie";
+    EXPECT_THROW(Movie::load(garbage), MovieError);
+
+    std::string const truncated = path("movie_truncated.mov");
+    record().save(truncated);
+    std::string bytes;
+    {
+        std::ifstream in(truncated, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    std::ofstream(truncated, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size() - 2);
+    EXPECT_THROW(Movie::load(truncated), MovieError);
+}
@@ -178,6 +178,13 @@ TEST_F(StatusTest, RRC) {
     emulator_.emulateOp();
     EXPECT_EQ(status.a, 0x41);
     EXPECT_FALSE(status.controls.c);
+
+    status.pc = 0;
+    status.controls.c = true;
+    status.a = 0x02;
+    emulator_.emulateOp();
+    EXPECT_EQ(status.a, 0x01);
+    EXPECT_FALSE(status.controls.c);
 }
 
 TEST_F(StatusTest, RAL) {
@@ -202,6 +209,23 @@ TEST_F(StatusTest, RAL) {
     EXPECT_TRUE(status.controls.c);
 }
 
+TEST_F(StatusTest, PUSH_POP_WrapAround) {
+    status.memory[0] = 0xc5; // PUSH B
+    status.memory[1] = 0xd1; // POP D
+    status.sp = 0x0001;
+    status.b = 0x12;
+    status.c = 0x34;
+    emulator_.emulateOp();
+    EXPECT_EQ(status.sp, 0xffff);
+    EXPECT_EQ(status.memory[0x0000], 0x12);
+    EXPECT_EQ(status.memory[0xffff], 0x34);
+
+    status.memory[1] = 0xd1;
+    emulator_.emulateOp();
+    EXPECT_EQ(status.d << 8 | status.e, 0x1234);
+    EXPECT_EQ(status.sp, 0x0001);
+}
+
 TEST_F(StatusTest, RAR) {
     status.memory[0] = 0x1f;
     status.a = 0x01;
@@ -298,6 +322,16 @@ TEST_F(StatusTest,  MOV_BM) {
     EXPECT_EQ(status.b, 0x11);
 }
 
+TEST_F(StatusTest,  MOV_AM) {
+    status.memory[0] = 0x7e;
+    status.a = 0x00;
+    status.h = 0x20;
+    status.l = 0x01;
+    status.memory[0x2001] = 0x42;
+    emulator_.emulateOp();
+    EXPECT_EQ(status.a, 0x42);
+}
+
 TEST_F(StatusTest,  ADD_B) {
     status.memory[0] = 0x80;
     status.a = 0x80;
@@ -405,7 +439,7 @@ TEST_F(StatusTest,  RNZ) {
     status.sp = 0x3000;
     status.controls.z = true;
     emulator_.emulateOp();
-    EXPECT_EQ(status.pc, 0x0);
+    EXPECT_EQ(status.pc, 0x1);
     EXPECT_EQ(status.sp, 0x3000);
 }
 
@@ -434,7 +468,7 @@ TEST_F(StatusTest,  JNZ) {
     status.pc = 0;
     status.controls.z = true;
     emulator_.emulateOp();
-    EXPECT_EQ(status.pc, 0x0000);
+    EXPECT_EQ(status.pc, 0x0003);
 }
 
 TEST_F(StatusTest, JMP) {
@@ -459,9 +493,10 @@ TEST_F(StatusTest, CNZ) {
     status.controls.z = false;
     emulator_.emulateOp();
     EXPECT_EQ(status.memory[0x2fff], 0x11);
-    EXPECT_EQ(status.memory[0x2ffe], 0x22);
+    EXPECT_EQ(status.memory[0x2ffe], 0x25);
     EXPECT_EQ(status.sp, 0x2ffe);
     EXPECT_EQ(status.pc, 0x1615);
+    EXPECT_EQ(status.cycles, 17);
 
     status.pc = 0x1122;
     status.memory[status.pc] = 0xc4;
@@ -476,7 +511,7 @@ TEST_F(StatusTest, CNZ) {
     EXPECT_EQ(status.memory[0x2fff], 0x00);
     EXPECT_EQ(status.memory[0x2ffe], 0x00);
     EXPECT_EQ(status.sp, 0x3000);
-    EXPECT_EQ(status.pc, 0x1122);
+    EXPECT_EQ(status.pc, 0x1125);
 }
 
 TEST_F(StatusTest, PUSH_B) {
@@ -535,7 +570,7 @@ TEST_F(StatusTest, RZ) {
 
     emulator_.emulateOp();
 
-    EXPECT_EQ(status.pc, 0x0000);
+    EXPECT_EQ(status.pc, 0x0001);
     EXPECT_EQ(status.sp, 0x3000);
 }
 
@@ -556,7 +591,7 @@ TEST_F(StatusTest, JZ) {
 
     emulator_.emulateOp();
 
-    EXPECT_EQ(status.pc, 0x0000);
+    EXPECT_EQ(status.pc, 0x0003);
 }
 
 TEST_F(StatusTest, ACI) {
@@ -583,11 +618,21 @@ TEST_F(StatusTest, ACI) {
 }
 
 TEST_F(StatusTest, IN) {
-    EXPECT_TRUE(false);
+    status.memory[status.pc] = 0xdb;
+    status.memory[status.pc+1] = 0x01;
+    emulator_.emulateOp();
+
+    EXPECT_EQ(status.pc, 0x0002);
+    EXPECT_EQ(status.cycles, 10);
 }
 
 TEST_F(StatusTest, OUT) {
-    EXPECT_TRUE(false);
+    status.memory[status.pc] = 0xd3;
+    status.memory[status.pc+1] = 0x03;
+    emulator_.emulateOp();
+
+    EXPECT_EQ(status.pc, 0x0002);
+    EXPECT_EQ(status.cycles, 10);
 }
 
 TEST_F(StatusTest, XCHG) {
@@ -669,3 +714,163 @@ TEST_F(StatusTest, PUSH_PSW) {
     EXPECT_EQ(status.memory[0x0003], 0xc7);
     EXPECT_EQ(status.sp, 0x0003);
 }
+
+TEST_F(StatusTest, DAA) {
+    status.memory[status.pc] = 0x27;
+    status.a = 0x9b;
+    status.controls.c = false;
+    status.controls.ac = false;
+
+    emulator_.emulateOp();
+
+    EXPECT_EQ(status.a, 0x01);
+    EXPECT_EQ(status.pc, 1);
+    EXPECT_TRUE(status.controls.c);
+    EXPECT_TRUE(status.controls.ac);
+    EXPECT_FALSE(status.controls.z);
+    EXPECT_FALSE(status.controls.s);
+    EXPECT_FALSE(status.controls.p);
+}
+
+TEST_F(StatusTest, DAA_AfterBcdAddition) {
+    status.memory[0] = 0x88; // ADC B
+    status.memory[1] = 0x27; // DAA
+    for (int carry = 0; carry < 2; ++carry) {
+        for (int x = 0; x < 100; ++x) {
+            for (int y = 0; y < 100; ++y) {
+                status.pc = 0;
+                status.a = x / 10 << 4 | x % 10;
+                status.b = y / 10 << 4 | y % 10;
+                status.controls.c = carry;
+                emulator_.emulateOp();
+                emulator_.emulateOp();
+
+                int const sum = (x + y + carry) % 100;
+                ASSERT_EQ(status.a, sum / 10 << 4 | sum % 10) << x << " + " << y << " + " << carry;
+                ASSERT_EQ(status.controls.c, x + y + carry >= 100) << x << " + " << y << " + " << carry;
+                ASSERT_EQ(status.controls.z, sum == 0);
+            }
+        }
+    }
+}
+
+TEST_F(StatusTest, AuxiliaryCarry) {
+    status.memory[0] = 0x80; // ADD B
+    status.a = 0x0f;
+    status.b = 0x01;
+    emulator_.emulateOp();
+    EXPECT_TRUE(status.controls.ac);
+
+    status.pc = 0;
+    status.a = 0x07;
+    emulator_.emulateOp();
+    EXPECT_FALSE(status.controls.ac);
+
+    status.memory[0] = 0x90; // SUB B
+    status.pc = 0;
+    status.a = 0x10;
+    emulator_.emulateOp();
+    EXPECT_FALSE(status.controls.ac);
+
+    status.pc = 0;
+    status.a = 0x12;
+    emulator_.emulateOp();
+    EXPECT_TRUE(status.controls.ac);
+
+    status.memory[0] = 0x04; // INR B
+    status.pc = 0;
+    status.b = 0x2f;
+    emulator_.emulateOp();
+    EXPECT_TRUE(status.controls.ac);
+
+    status.memory[0] = 0x05; // DCR B
+    status.pc = 0;
+    emulator_.emulateOp();
+    EXPECT_FALSE(status.controls.ac);
+
+    status.memory[0] = 0xa0; // ANA B
+    status.pc = 0;
+    status.a = 0x08;
+    status.b = 0x00;
+    emulator_.emulateOp();
+    EXPECT_TRUE(status.controls.ac);
+
+    status.memory[0] = 0xa8; // XRA B
+    status.pc = 0;
+    emulator_.emulateOp();
+    EXPECT_FALSE(status.controls.ac);
+}
+
+TEST_F(StatusTest, PSW_AuxiliaryCarry) {
+    status.memory[0] = 0xf5; // PUSH PSW
+    status.memory[1] = 0xf1; // POP PSW
+    status.sp = 0x3000;
+    status.controls.ac = true;
+
+    emulator_.emulateOp();
+    EXPECT_EQ(status.memory[0x2ffe], 0x12);
+
+    status.controls.ac = false;
+    emulator_.emulateOp();
+    EXPECT_TRUE(status.controls.ac);
+}
+
+TEST_F(StatusTest, HLT) {
+    status.memory[0x0010] = 0x76;
+    status.pc = 0x0010;
+
+    EXPECT_EQ(emulator_.emulateOp(), StopReason::HALTED);
+    EXPECT_EQ(status.pc, 0x0011);
+    EXPECT_EQ(status.cycles, 7);
+    EXPECT_EQ(emulator_.lastStop().reason, StopReason::HALTED);
+    EXPECT_EQ(emulator_.lastStop().pc, 0x0010);
+    EXPECT_EQ(emulator_.lastStop().opcode, 0x76);
+}
+
+TEST_F(StatusTest, UnimplementedOpcodePolicies) {
+    status.memory[0x0020] = 0xff;
+    status.pc = 0x0020;
+    status.sp = 0x3000;
+
+    EXPECT_EQ(emulator_.emulateOp(), StopReason::UNIMPLEMENTED_OPCODE);
+    EXPECT_EQ(status.pc, 0x0020);
+    EXPECT_EQ(status.cycles, 0);
+    EXPECT_EQ(emulator_.lastStop().pc, 0x0020);
+    EXPECT_EQ(emulator_.lastStop().opcode, 0xff);
+    EXPECT_EQ(emulator_.lastStop().describe(), "unimplemented opcode at $0020 (opcode ff)");
+
+    emulator_.setUnimplementedPolicy(UnimplementedPolicy::NOP);
+    EXPECT_EQ(emulator_.emulateOp(), StopReason::NONE);
+    EXPECT_EQ(status.pc, 0x0021);
+    EXPECT_EQ(status.sp, 0x3000);
+
+    int calls = 0;
+    emulator_.setUnimplementedPolicy(UnimplementedPolicy::CALLBACK, [&](Emulator&, Stop const& stop) {
+        ++calls;
+        EXPECT_EQ(stop.opcode, 0xff);
+        return calls == 1;
+    });
+    status.pc = 0x0020;
+    EXPECT_EQ(emulator_.emulateOp(), StopReason::NONE);
+    EXPECT_EQ(status.pc, 0x0021);
+    status.pc = 0x0020;
+    EXPECT_EQ(emulator_.emulateOp(), StopReason::UNIMPLEMENTED_OPCODE);
+    EXPECT_EQ(status.pc, 0x0020);
+    EXPECT_EQ(calls, 2);
+}
+
+TEST_F(StatusTest, RunReportsStop) {
+    status.memory[0] = 0x00;
+    status.memory[1] = 0x76;
+
+    Stop stop = emulator_.run(1000);
+    EXPECT_EQ(stop.reason, StopReason::HALTED);
+    EXPECT_EQ(stop.pc, 0x0001);
+
+    status.pc = 0x0000;
+    status.memory[1] = 0xc3;    // JMP $0000
+    status.memory[2] = 0x00;
+    status.memory[3] = 0x00;
+    stop = emulator_.run(100);
+    EXPECT_EQ(stop.reason, StopReason::CYCLE_BUDGET);
+}
@@ -0,0 +1,56 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <ctime>
+#include <thread>
+#include <pacer.h>
+
+using namespace std::chrono_literals;
+
+TEST(PacerTest, KeepsToThePeriod) {
+    Pacer pacer(5ms);
+    auto const start = Pacer::Clock::now();
+    std::clock_t const cpuStart = std::clock();
+    for (int frame = 0; frame < 40; ++frame) { pacer.wait(); }
+    double const wall = std::chrono::duration<double>(Pacer::Clock::now() - start).count();
+    double const cpu = double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+    // Deadlines are absolute, so the total stays on schedule however each wake-up went.
+    EXPECT_GE(wall, 0.199);
+    EXPECT_LT(wall, 0.300);
+    EXPECT_EQ(pacer.stats().frames, 40u);
+    // Most of the wait is spent asleep.
+    EXPECT_LT(cpu, wall / 2);
+}
+
+TEST(PacerTest, CountsMissedDeadlines) {
+    Pacer pacer(2ms, 5);
+    pacer.wait();
+    std::this_thread::sleep_for(5ms);   // A slow frame: two periods late.
+    pacer.wait();
+    EXPECT_GE(pacer.stats().missed, 1u);
+    EXPECT_EQ(pacer.stats().resyncs, 0u);
+
+    // Catching up runs frames back to back instead of waiting.
+    auto const start = Pacer::Clock::now();
+    pacer.wait();
+    EXPECT_LT(Pacer::Clock::now() - start, 1ms);
+
+    std::this_thread::sleep_for(20ms);  // Too far behind: the schedule restarts.
+    pacer.wait();
+    EXPECT_EQ(pacer.stats().resyncs, 1u);
+    uint64_t const missed = pacer.stats().missed;
+    pacer.wait();
+    EXPECT_EQ(pacer.stats().missed, missed);
+    EXPECT_EQ(pacer.stats().frames, 5u);
+}
+
+TEST(PacerTest, Describe) {
+    Pacer pacer(1ms);
+    pacer.wait();
+    std::string const text = pacer.stats().describe();
+    EXPECT_NE(text.find("1 frames"), std::string::npos) << text;
+    EXPECT_NE(text.find("jitter"), std::string::npos) << text;
+}
@@ -0,0 +1,70 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <emulator.h>
+#include <perfcounters.h>
+#include <workloads.h>
+
+TEST(PerfCountersTest, OpClasses) {
+    EXPECT_EQ(opClass(0x7e), OpClass::MOVE);       // MOV A,M
+    EXPECT_EQ(opClass(0x76), OpClass::MACHINE);    // HLT
+    EXPECT_EQ(opClass(0x21), OpClass::MOVE);       // LXI H
+    EXPECT_EQ(opClass(0x29), OpClass::PAIR);       // DAD H
+    EXPECT_EQ(opClass(0x1b), OpClass::PAIR);       // DCX D
+    EXPECT_EQ(opClass(0x3c), OpClass::ALU);        // INR A
+    EXPECT_EQ(opClass(0x27), OpClass::ALU);        // DAA
+    EXPECT_EQ(opClass(0xfe), OpClass::ALU);        // CPI
+    EXPECT_EQ(opClass(0xf5), OpClass::STACK);      // PUSH PSW
+    EXPECT_EQ(opClass(0xc1), OpClass::STACK);      // POP B
+    EXPECT_EQ(opClass(0xc2), OpClass::BRANCH);     // JNZ
+    EXPECT_EQ(opClass(0xe9), OpClass::BRANCH);     // PCHL
+    EXPECT_EQ(opClass(0xc9), OpClass::CALL);       // RET
+    EXPECT_EQ(opClass(0xcd), OpClass::CALL);       // CALL
+    EXPECT_EQ(opClass(0xff), OpClass::CALL);       // RST 7
+    EXPECT_EQ(opClass(0xeb), OpClass::MOVE);       // XCHG
+    EXPECT_EQ(opClass(0xf9), OpClass::MOVE);       // SPHL
+    EXPECT_EQ(opClass(0xd3), OpClass::MACHINE);    // OUT
+    EXPECT_EQ(opClass(0xfb), OpClass::MACHINE);    // EI
+    EXPECT_EQ(opClass(0x00), OpClass::MACHINE);    // NOP
+}
+
+TEST(PerfCountersTest, ProfilerChargesEveryOpToItsClass) {
+    PerfCounters counters;
+    PerfProfiler profiler(counters);
+    Workload const& workload = standardWorkloads()[1];
+    Emulator emulator;
+    uint64_t const expected = runWorkload(emulator, workload);
+    std::copy(workload.program.begin(), workload.program.end(), emulator.status_.memory.begin());
+    emulator.status_.pc = 0;
+
+    counters.start();
+    while (emulator.status_.pc != workload.exit) { emulator.run(1, profiler); }
+    counters.stop();
+    uint64_t ops = 0;
+    for (size_t kind = 0; kind < opClassCount; ++kind) { ops += profiler.ops(static_cast<OpClass>(kind)); }
+    EXPECT_EQ(ops, expected);
+    EXPECT_GT(profiler.ops(OpClass::PAIR), 0u);
+    EXPECT_NE(profiler.report().find("pair"), std::string::npos);
+    if (counters.available(HostEvent::INSTRUCTIONS)) {
+        EXPECT_GT(profiler.counts(OpClass::ALU)[static_cast<size_t>(HostEvent::INSTRUCTIONS)], 0u);
+    }
+}
+
+TEST(PerfCountersTest, CountsOnlyWhileStarted) {
+    PerfCounters counters;
+    HostCounts const idle = counters.read();
+    for (uint64_t count: idle) { EXPECT_EQ(count, 0u); }
+    if (!counters.available(HostEvent::INSTRUCTIONS)) {
+        GTEST_SKIP() << "no instruction counter on this host";
+    }
+    Emulator emulator;
+    counters.start();
+    uint64_t const ops = runWorkload(emulator, standardWorkloads()[0]);
+    counters.stop();
+    HostCounts const counts = counters.read();
+    // Far more host instructions than emulated ops, and nothing more once stopped.
+    EXPECT_GT(counts[static_cast<size_t>(HostEvent::INSTRUCTIONS)], ops);
+    EXPECT_EQ(counters.read(), counts);
+}
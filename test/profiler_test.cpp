@@ -0,0 +1,79 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <emulator.h>
+#include <profiler.h>
+
+class ProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // 0000 LXI SP,$2400
+        // 0003 MVI B,$03
+        // 0005 CALL $0010
+        // 0008 DCR B
+        // 0009 JNZ $0005
+        // 000c HLT
+        // 0010 NOP
+        // 0011 RET
+        std::vector<Byte> program {0x31, 0x00, 0x24, 0x06, 0x03, 0xcd, 0x10, 0x00, 0x05, 0xc2, 0x05, 0x00, 0x76};
+        std::copy(program.begin(), program.end(), status.memory.begin());
+        status.memory[0x10] = 0x00;
+        status.memory[0x11] = 0xc9;
+    }
+
+    Emulator emulator_;
+    Status& status = emulator_.status_;
+};
+
+TEST_F(ProfilerTest, CountsPcsOpcodesAndCalls) {
+    Profiler profiler;
+    emulator_.run(10 + 7 + 3 * (17 + 4 + 10 + 5 + 10), profiler);
+
+    EXPECT_EQ(status.pc, 0x000c);
+    EXPECT_EQ(profiler.hits(0x0000), 1);
+    EXPECT_EQ(profiler.hits(0x0005), 3);
+    EXPECT_EQ(profiler.hits(0x0011), 3);
+    EXPECT_EQ(profiler.hits(0x000c), 0);
+    EXPECT_EQ(profiler.opcodeHits(0xcd), 3);
+    EXPECT_EQ(profiler.opcodeHits(0x05), 3);
+    EXPECT_EQ(profiler.pairHits(0x05, 0xc2), 3);    // DCR B; JNZ
+    EXPECT_EQ(profiler.pairHits(0x06, 0xcd), 1);    // MVI B; CALL
+    EXPECT_EQ(profiler.pairHits(0x00, 0xc9), 3);    // NOP; RET
+    EXPECT_EQ(profiler.pairHits(0xcd, 0x05), 0);    // The CALL goes elsewhere first.
+    EXPECT_EQ(profiler.pairHits(0xc2, 0xcd), 0);    // Nor is the CALL after the JNZ in memory.
+    EXPECT_EQ(profiler.callStats(0x0010).calls, 3);
+    EXPECT_EQ(profiler.callStats(0x0010).cycles, 3 * (17 + 4 + 10));
+}
+
+TEST_F(ProfilerTest, ReportIsAnnotated) {
+    Profiler profiler;
+    emulator_.run(100, profiler);
+    std::string report = profiler.report(status.memory, 5);
+    EXPECT_NE(report.find("0005\tCALL $0010"), std::string::npos);
+    EXPECT_NE(report.find("calls  $0010"), std::string::npos);
+
+    profiler.reset();
+    EXPECT_EQ(profiler.hits(0x0005), 0);
+}
+
+TEST_F(ProfilerTest, DisabledRunMatches) {
+    Emulator reference;
+    reference.status_.memory = status.memory;
+    reference.run(100);
+    emulator_.run(100, Profiler{});
+    EXPECT_EQ(reference.status_.pc, status.pc);
+    EXPECT_EQ(reference.status_.cycles, status.cycles);
+}
+
+TEST_F(ProfilerTest, SkipsUnimplementedStop) {
+    status.memory[0x0010] = 0xff;   // Unimplemented; the CALL's target now stops the run.
+    Profiler profiler;
+    Stop const stop = emulator_.run(100, profiler);
+    EXPECT_EQ(stop.reason, StopReason::UNIMPLEMENTED_OPCODE);
+    EXPECT_EQ(status.pc, 0x0010);
+    EXPECT_EQ(profiler.hits(0x0010), 0);
+    EXPECT_EQ(profiler.opcodeHits(0xff), 0);
+    EXPECT_EQ(profiler.opcodeHits(0xcd), 1);
+}
@@ -0,0 +1,91 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sys/wait.h>
+#include <invaders.h>
+#include <movie.h>
+
+// Records a session through cpu8080 run --record and plays it back with cpu8080 replay.
+class RecordTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        namespace fs = std::filesystem;
+        fs::remove_all(root_);
+        fs::create_directories(root_);
+        // Sums every IN 1 into $2000 and keeps the last IN 2 at $2002, as in MovieTest.
+        std::vector<Byte> image {
+            0x31, 0x00, 0x24,   // 0000 LXI SP,$2400
+            0xf3,               // 0003 DI
+            0xdb, 0x01,         // 0004 IN 1
+            0x47,               // 0006 MOV B,A
+            0x3a, 0x00, 0x20,   // 0007 LDA $2000
+            0x80,               // 000a ADD B
+            0x32, 0x00, 0x20,   // 000b STA $2000
+            0xdb, 0x02,         // 000e IN 2
+            0x32, 0x02, 0x20,   // 0010 STA $2002
+            0xc3, 0x04, 0x00,   // 0013 JMP $0004
+        };
+        image.resize(0x800);
+        std::vector<Byte> const empty(0x800);
+        for (char const* part: {"h", "g", "f", "e"}) {
+            std::vector<Byte> const& bytes = part[0] == 'h' ? image : empty;
+            std::ofstream(root_ / (std::string("invaders.") + part), std::ios::binary)
+                    .write(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+        }
+        std::ofstream(root_ / "keys.txt") << "3 coin down\n6 coin up\n10 p1_fire down\n20 p1_fire up\n22 p2_right down\n";
+    }
+
+    void TearDown() override { std::filesystem::remove_all(root_); }
+
+    // Runs cpu8080 with arguments, returning its exit status and putting its output in output.
+    int cpu8080(std::string const& arguments, std::string& output) {
+        FILE* pipe = popen((std::string("\"") + CPU8080_BINARY + "\" " + arguments + " 2>&1").c_str(), "r");
+        if (!pipe) { return -1; }
+        output.clear();
+        char buffer[256];
+        for (size_t count; (count = fread(buffer, 1, sizeof buffer, pipe)) > 0;) { output.append(buffer, count); }
+        int const status = pclose(pipe);
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+
+    std::string at(char const* name) const { return "\"" + (root_ / name).string() + "\""; }
+
+    std::filesystem::path const root_ = std::filesystem::path(::testing::TempDir()) / "record_test";
+};
+
+TEST_F(RecordTest, RecordThenReplay) {
+    std::string output;
+    ASSERT_EQ(cpu8080("run --input " + at("keys.txt") + " --record " + at("session.mov") + " " + at("") + " 0.5", output), 0)
+            << output;
+    EXPECT_NE(output.find("over 30 frames recorded"), std::string::npos) << output;
+
+    Movie const movie = Movie::load((root_ / "session.mov").string());
+    EXPECT_EQ(Invaders::frame(movie.endCycles), 30u);
+    bool coin = false;
+    for (auto const& read: movie.reads) { coin = coin || (read.port == 1 && (read.value & 0x01)); }
+    EXPECT_TRUE(coin);
+
+    ASSERT_EQ(cpu8080("replay -j 1 " + at("") + " " + at("session.mov"), output), 0) << output;
+    EXPECT_NE(output.find("30 frames"), std::string::npos) << output;
+    EXPECT_NE(output.find(", ok"), std::string::npos) << output;
+
+    // Without the inputs the same ROM ends elsewhere.
+    Movie idle = movie;
+    idle.reads.clear();
+    idle.save((root_ / "idle.mov").string());
+    EXPECT_EQ(cpu8080("replay -j 1 " + at("") + " " + at("idle.mov"), output), 1) << output;
+    EXPECT_NE(output.find("DIVERGED"), std::string::npos) << output;
+}
+
+TEST_F(RecordTest, ScriptFromStdin) {
+    std::string output;
+    ASSERT_EQ(cpu8080("run --input - --record " + at("stdin.mov") + " " + at("") + " 0.25 < " + at("keys.txt"), output), 0)
+            << output;
+    ASSERT_EQ(cpu8080("replay " + at("") + " " + at("stdin.mov"), output), 0) << output;
+    EXPECT_NE(output.find(", ok"), std::string::npos) << output;
+}
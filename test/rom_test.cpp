@@ -0,0 +1,57 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <emulator.h>
+#include <rom.h>
+
+class RomTest : public ::testing::Test {
+protected:
+    std::string writeFile(std::string const& name, std::vector<Byte> const& bytes) {
+        std::string filename = ::testing::TempDir() + name;
+        std::ofstream out(filename, std::ios::binary);
+        out.write(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+        files_.push_back(filename);
+        return filename;
+    }
+
+    void TearDown() override {
+        for (auto const& f: files_) { std::remove(f.c_str()); }
+    }
+
+    std::vector<std::string> files_;
+};
+
+TEST_F(RomTest, MapsFileReadOnly) {
+    auto filename = writeFile("rom_single.bin", {0xc3, 0x00, 0x10});
+    auto rom = mapRom(filename);
+    ASSERT_EQ(rom->bytes().size(), 3);
+    EXPECT_EQ(rom->bytes()[0], 0xc3);
+    EXPECT_EQ(mapRom(filename).get(), rom.get());
+}
+
+TEST_F(RomTest, LoadsPartsAtOffsets) {
+    std::vector<RomPart> parts {
+        {writeFile("rom_part_h.bin", {0x01, 0x02}), 0x0000},
+        {writeFile("rom_part_g.bin", {0x03}), 0x0800},
+    };
+    Emulator emulator;
+    emulator.setMemory(parts);
+    EXPECT_EQ(emulator.status_.memory[0x0000], 0x01);
+    EXPECT_EQ(emulator.status_.memory[0x0001], 0x02);
+    EXPECT_EQ(emulator.status_.memory[0x0800], 0x03);
+}
+
+TEST_F(RomTest, ReportsErrors) {
+    std::vector<Byte> memory(addressSpaceSize);
+    EXPECT_THROW(loadRom({{::testing::TempDir() + "rom_missing.bin", 0}}, memory), RomLoadError);
+    EXPECT_THROW(loadRom({{writeFile("rom_empty.bin", {}), 0}}, memory), RomLoadError);
+    EXPECT_THROW(loadRom({{writeFile("rom_large.bin", std::vector<Byte>(addressSpaceSize + 1)), 0}}, memory), RomLoadError);
+
+    auto part = writeFile("rom_part.bin", {0x00, 0x00, 0x00, 0x00});
+    EXPECT_THROW(loadRom({{part, 0xfffe}}, memory), RomLoadError);
+    EXPECT_THROW(loadRom({{part, 0x0000}, {part, 0x0002}}, memory), RomLoadError);
+}
@@ -0,0 +1,109 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <emulator.h>
+#include <invaders.h>
+#include <sound.h>
+
+namespace {
+
+constexpr unsigned sampleRate = 44100;
+
+Mixer::Samples testSamples() {
+    Mixer::Samples samples;
+    for (int sound = 0; sound < Mixer::soundCount; ++sound) {
+        for (int i = 0; i < 300 + 50 * sound; ++i) { samples[sound].push_back((sound + 1) * 100 + i % 7); }
+    }
+    return samples;
+}
+
+// Counts in B and writes the count to port 3 and, shifted, to port 5 about every 1,500 cycles.
+void load(Emulator& emulator) {
+    std::vector<Byte> const program {
+        0x31, 0x00, 0x24,   // 0000 LXI SP,$2400
+        0xf3,               // 0003 DI
+        0x04,               // 0004 INR B
+        0x78,               // 0005 MOV A,B
+        0xd3, 0x03,         // 0006 OUT 3
+        0x0f,               // 0008 RRC
+        0xd3, 0x05,         // 0009 OUT 5
+        0x0e, 0x64,         // 000b MVI C,100
+        0x0d,               // 000d DCR C
+        0xc2, 0x0d, 0x00,   // 000e JNZ $000d
+        0xc3, 0x04, 0x00,   // 0011 JMP $0004
+    };
+    std::copy(program.begin(), program.end(), emulator.status_.memory.begin());
+}
+
+void runFrames(SoundBoard& board, int frames) {
+    Emulator emulator;
+    load(emulator);
+    Invaders machine;
+    machine.setSoundBoard(&board);
+    machine.attach(emulator);
+    for (int frame = 0; frame < frames; ++frame) { machine.runFrame(emulator); }
+}
+
+}
+
+TEST(SoundTest, MixerTimesSamplesByCycle) {
+    Mixer::Samples samples;
+    samples[0] = {1, 2};            // UFO
+    samples[1] = {100, 200, 300};   // Shot
+    Mixer mixer(samples, 1000, 2000000);    // A sample every 2,000 cycles.
+    std::vector<int16_t> out;
+
+    mixer.apply({4000, 3, 0x02}, out);
+    mixer.render(10000, out);
+    mixer.apply({10000, 3, 0x03}, out);    // The shot bit stays set and does not restart.
+    mixer.render(20000, out);
+    mixer.apply({20000, 3, 0x00}, out);
+    mixer.render(24000, out);
+    EXPECT_EQ(out, (std::vector<int16_t> {0, 0, 100, 200, 300, 1, 2, 1, 2, 1, 0, 0}));
+}
+
+TEST(SoundTest, MixerSumsAndClamps) {
+    Mixer::Samples samples;
+    samples[4] = {30000, 30000, 1};
+    samples[5] = {30000, -1, 1};
+    Mixer mixer(samples, 1000, 1000);
+    std::vector<int16_t> out;
+    mixer.apply({0, 5, 0x03}, out);
+    mixer.render(4, out);
+    EXPECT_EQ(out, (std::vector<int16_t> {32767, 29999, 2, 0}));
+}
+
+TEST(SoundTest, OfflineMatchesMixerThread) {
+    SoundBoard offline(testSamples(), sampleRate, Invaders::clockHz);
+    runFrames(offline, 10);
+    std::vector<int16_t> const& expected = offline.offline();
+    EXPECT_EQ(expected.size() / (sampleRate / 60), 10u);
+    EXPECT_NE(std::count(expected.begin(), expected.end(), 0), (long) expected.size());
+
+    SoundBoard live(testSamples(), sampleRate, Invaders::clockHz);
+    live.start();
+    runFrames(live, 10);
+    live.stop();
+    std::vector<int16_t> mixed(expected.size() + 100);
+    mixed.resize(live.read(mixed));
+    EXPECT_EQ(live.droppedEvents(), 0u);
+    EXPECT_EQ(live.droppedSamples(), 0u);
+    EXPECT_TRUE(live.offline().empty());
+    EXPECT_EQ(mixed, expected);
+}
+
+TEST(SoundTest, WavFiles) {
+    std::string const filename = ::testing::TempDir() + "sound_test.wav";
+    std::vector<int16_t> const samples {0, 1000, -1000, 32767, -32768, 5};
+    writeWav(filename, samples, 22050);
+    EXPECT_EQ(loadWav(filename, 22050), samples);
+    EXPECT_EQ(loadWav(filename, 44100).size(), 12u);
+    std::ofstream(filename) << "RIFF....WAVEjunk";
+    EXPECT_THROW(loadWav(filename, 44100), AudioError);
+    std::remove(filename.c_str());
+    EXPECT_THROW(loadWav(filename, 44100), AudioError);
+}
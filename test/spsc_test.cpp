@@ -0,0 +1,52 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <thread>
+#include <spsc.h>
+
+TEST(SpscQueueTest, FillsAndDrains) {
+    SpscQueue<int> queue(3);
+    EXPECT_EQ(queue.capacity(), 4u);
+    int value = 0;
+    EXPECT_FALSE(queue.pop(value));
+    for (int i = 0; i < 4; ++i) { EXPECT_TRUE(queue.push(i)); }
+    EXPECT_FALSE(queue.push(4));
+    EXPECT_EQ(queue.size(), 4u);
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.pop(value));
+    EXPECT_TRUE(queue.push(5));     // Wraps around.
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, 5);
+}
+
+TEST(SpscQueueTest, TwoThreadsKeepOrder) {
+    SpscQueue<uint64_t> queue(64);
+    constexpr uint64_t count = 200000;
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < count;) {
+            if (queue.push(i)) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint64_t expected = 0;
+    uint64_t value = 0;
+    while (expected < count) {
+        if (!queue.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        EXPECT_EQ(value, expected);
+        ++expected;
+    }
+    producer.join();
+    EXPECT_EQ(queue.size(), 0u);
+}
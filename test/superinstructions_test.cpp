@@ -0,0 +1,118 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <random>
+#include <emulator.h>
+#include <superinstructions.h>
+#include <workloads.h>
+
+namespace {
+
+constexpr uint16_t at = 0x4000;
+
+void expectSameState(Emulator const& fused, Emulator const& single, std::string const& what) {
+    Status const& f = fused.status_;
+    Status const& s = single.status_;
+    EXPECT_EQ(f.pc, s.pc) << what;
+    EXPECT_EQ(f.cycles, s.cycles) << what;
+    EXPECT_EQ(fused.psw(), single.psw()) << what;
+    EXPECT_EQ(f.a, s.a) << what;
+    EXPECT_EQ(f.b << 8 | f.c, s.b << 8 | s.c) << what;
+    EXPECT_EQ(f.d << 8 | f.e, s.d << 8 | s.e) << what;
+    EXPECT_EQ(f.h << 8 | f.l, s.h << 8 | s.l) << what;
+    EXPECT_EQ(f.sp, s.sp) << what;
+    EXPECT_TRUE(f.memory == s.memory) << what;
+}
+
+// Random registers, flags and memory around at, with the pair at at and random operands. HL, DE
+// and BC sometimes point into the pair itself, to catch ops that write into the second op.
+void randomize(Emulator& emulator, uint16_t pair, std::mt19937& random) {
+    Status& s = emulator.status_;
+    for (uint16_t address = at - 0x100; address < at + 0x100; ++address) { s.memory[address] = random(); }
+    for (Byte* r: {&s.a, &s.b, &s.c, &s.d, &s.e, &s.h, &s.l}) { *r = random(); }
+    s.sp = random();
+    emulator.setPsw(random());
+    s.memory[at] = pair >> 8;
+    s.memory[at + opcodes[pair >> 8].length] = pair & 0xff;
+    for (auto [high, low]: {std::pair {&s.b, &s.c}, std::pair {&s.d, &s.e}, std::pair {&s.h, &s.l}}) {
+        if (random() % 4 == 0) {
+            uint16_t const target = at + random() % 5;
+            *high = target >> 8;
+            *low = target & 0xff;
+        } else if (random() % 2 == 0) {
+            *high = (at + 0x80) >> 8;    // Somewhere nearby, to read back what was written.
+        }
+    }
+    s.pc = at;
+    s.cycles = random() % 1000;
+}
+
+}
+
+TEST(SuperinstructionsTest, PairsMatchTheirOps) {
+    std::mt19937 random(8080);
+    for (uint16_t pair: superinstructions::pairs) {
+        Byte const first = pair >> 8;
+        Byte const second = pair & 0xff;
+        char what[16];
+        std::snprintf(what, sizeof what, "pair %02x %02x", first, second);
+        uint64_t fusedRuns = 0;
+        for (int trial = 0; trial < 2000; ++trial) {
+            Emulator fused;
+            fused.setFusion(true);
+            randomize(fused, pair, random);
+            Emulator single;
+            single.status_ = fused.status_;
+
+            // Exactly enough budget for both ops; what run does one op at a time when they are not fused.
+            uint64_t const end = fused.status_.cycles + opcodes[first].cycles + opcodes[second].cycles;
+            fused.run(end - fused.status_.cycles);
+            while (single.status_.cycles < end && single.emulateOp() == StopReason::NONE) {}
+            expectSameState(fused, single, what);
+            fusedRuns += fused.fusedDispatches();
+            if (::testing::Test::HasFailure()) { return; }
+        }
+        // Only the trials that wrote into the second op fall back.
+        EXPECT_GT(fusedRuns, 1000u) << what;
+    }
+}
+
+TEST(SuperinstructionsTest, BudgetEndingAfterTheFirstOp) {
+    for (uint16_t pair: superinstructions::pairs) {
+        Byte const first = pair >> 8;
+        Emulator fused;
+        fused.setFusion(true);
+        std::mt19937 random(pair);
+        randomize(fused, pair, random);
+        fused.status_.h = 0x10;     // Away from the code.
+        Emulator single;
+        single.status_ = fused.status_;
+        fused.run(opcodes[first].cycles);
+        single.emulateOp();
+        EXPECT_EQ(fused.fusedDispatches(), 0u);
+        expectSameState(fused, single, "budget");
+    }
+}
+
+TEST(SuperinstructionsTest, Workloads) {
+    for (auto const& workload: standardWorkloads()) {
+        Emulator fused;
+        fused.setFusion(true);
+        Emulator single;
+        for (Emulator* emulator: {&fused, &single}) {
+            std::copy(workload.program.begin(), workload.program.end(), emulator->status_.memory.begin());
+        }
+        // Odd slices, so budgets end in the middle of pairs.
+        StopReason reason = StopReason::CYCLE_BUDGET;
+        for (int i = 0; i < 100000 && reason == StopReason::CYCLE_BUDGET; ++i) {
+            EXPECT_EQ(fused.run(97).reason, reason = single.run(97).reason);
+            expectSameState(fused, single, workload.name);
+            if (::testing::Test::HasFailure()) { return; }
+        }
+        EXPECT_EQ(reason, StopReason::HALTED);
+        EXPECT_GT(fused.fusedDispatches(), 0u) << workload.name;
+        EXPECT_EQ(single.fusedDispatches(), 0u);
+    }
+}
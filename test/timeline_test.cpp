@@ -0,0 +1,139 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <emulator.h>
+#include <timeline.h>
+#include <workloads.h>
+
+namespace {
+
+struct State {
+    uint16_t pc, sp, bc, de, hl;
+    Byte a, flags;
+    uint64_t cycles;
+    std::vector<Byte> memory;
+
+    bool operator==(State const&) const = default;
+};
+
+State capture(Emulator const& emulator) {
+    Status const& s = emulator.status_;
+    return {s.pc, s.sp, (uint16_t) (s.b << 8 | s.c), (uint16_t) (s.d << 8 | s.e), (uint16_t) (s.h << 8 | s.l),
+            s.a, emulator.psw(), s.cycles, s.memory};
+}
+
+void load(Emulator& emulator, Workload const& workload) {
+    std::copy(workload.program.begin(), workload.program.end(), emulator.status_.memory.begin());
+}
+
+}
+
+TEST(TimelineTest, StepBackRetracesEveryOp) {
+    Workload const& workload = standardWorkloads()[0];
+    Emulator reference;
+    load(reference, workload);
+    std::vector<State> states {capture(reference)};
+    for (int i = 0; i < 2000; ++i) {
+        reference.emulateOp();
+        states.push_back(capture(reference));
+    }
+
+    Emulator emulator;
+    load(emulator, workload);
+    Timeline timeline(500);
+    timeline.run(emulator, states.back().cycles);
+    ASSERT_EQ(capture(emulator), states.back());
+    EXPECT_GT(timeline.snapshots(), 10u);
+
+    for (size_t i = states.size() - 1; i-- > 0;) {
+        ASSERT_TRUE(timeline.stepBack(emulator)) << i;
+        ASSERT_EQ(capture(emulator), states[i]) << i;
+    }
+    EXPECT_FALSE(timeline.stepBack(emulator));
+    EXPECT_EQ(timeline.snapshots(), 1u);
+}
+
+TEST(TimelineTest, SeekLandsOnOpBoundaries) {
+    Emulator emulator;
+    load(emulator, standardWorkloads()[1]);
+    Timeline timeline(1000);
+    timeline.run(emulator, 20000);
+    State const end = capture(emulator);
+
+    // Within an op, seek stops at its start; resuming from there gets back to the same state.
+    ASSERT_TRUE(timeline.seek(emulator, 10001));
+    EXPECT_LE(emulator.status_.cycles, 10001u);
+    EXPECT_GT(emulator.status_.cycles + 18, 10001u);
+    while (emulator.status_.cycles < end.cycles) { emulator.emulateOp(); }
+    EXPECT_EQ(capture(emulator), end);
+
+    EXPECT_FALSE(timeline.seek(emulator, end.cycles + 1));
+}
+
+TEST(TimelineTest, MemoryBudgetBoundsHistory) {
+    Emulator emulator;
+    load(emulator, standardWorkloads()[0]);
+    size_t const budget = 256 << 10;
+    Timeline timeline(200, budget);
+    timeline.run(emulator, 50000);
+
+    EXPECT_LE(timeline.memoryUsed(), budget);
+    EXPECT_GT(timeline.oldestCycle(), 0u);
+    // Unchanged pages are shared, so the history holds far more than budget / 64 KiB snapshots.
+    EXPECT_GT(timeline.snapshots(), 4u);
+
+    uint64_t const now = emulator.status_.cycles;
+    EXPECT_FALSE(timeline.seek(emulator, timeline.oldestCycle() - 1));
+    EXPECT_EQ(emulator.status_.cycles, now);
+    EXPECT_TRUE(timeline.seek(emulator, timeline.oldestCycle()));
+    EXPECT_EQ(emulator.status_.cycles, timeline.oldestCycle());
+}
+
+TEST(TimelineTest, StopsLikeRun) {
+    Emulator emulator;
+    load(emulator, standardWorkloads()[0]);
+    emulator.debugger_.addBreakpoint(0x000f);
+    Timeline timeline(7);   // Slices end at all sorts of ops, including the breakpoint's.
+
+    for (int hit = 0; hit < 50; ++hit) {
+        Stop const stop = timeline.run(emulator, 1000000);
+        ASSERT_EQ(stop.reason, StopReason::BREAKPOINT);
+        ASSERT_EQ(emulator.status_.h << 8 | emulator.status_.l, 0x3000 + hit);
+    }
+    emulator.debugger_.clear();
+    EXPECT_EQ(timeline.run(emulator, 1000000).reason, StopReason::HALTED);
+}
+
+TEST(TimelineTest, SeekReplaysInterrupts) {
+    // 0000 LXI SP,$2400; EI; loop: INR B; JMP loop. RST 1 handler at 0008: INR C; EI; RET.
+    std::vector<Byte> const program {0x31, 0x00, 0x24, 0xfb, 0x04, 0xc3, 0x04, 0x00, 0x0c, 0xfb, 0xc9};
+    Emulator reference;
+    std::copy(program.begin(), program.end(), reference.status_.memory.begin());
+    std::vector<State> states {capture(reference)};
+    for (int i = 0; i < 10; ++i) {
+        uint64_t const end = reference.status_.cycles + 1000;
+        while (reference.status_.cycles < end) {
+            reference.emulateOp();
+            states.push_back(capture(reference));
+        }
+        ASSERT_TRUE(reference.interrupt(1));
+        states.push_back(capture(reference));
+    }
+
+    Emulator emulator;
+    std::copy(program.begin(), program.end(), emulator.status_.memory.begin());
+    Timeline timeline(300);
+    for (int i = 0; i < 10; ++i) {
+        timeline.run(emulator, 1000);
+        ASSERT_TRUE(emulator.interrupt(1));
+    }
+    ASSERT_EQ(capture(emulator), states.back());
+
+    for (size_t i = states.size() - 1; i-- > 0;) {
+        ASSERT_TRUE(timeline.stepBack(emulator)) << i;
+        ASSERT_EQ(capture(emulator), states[i]) << i;
+    }
+    EXPECT_FALSE(timeline.stepBack(emulator));
+}
@@ -0,0 +1,49 @@
+//
+// Created by KarlE on 10/19/2026.
+//
+
+#include "gtest/gtest.h"
+#include <workloads.h>
+
+TEST(WorkloadsTest, RoutinesComputeTheirResults) {
+    auto const& workloads = standardWorkloads();
+    ASSERT_EQ(workloads.size(), 4);
+    Emulator emulator;
+    Status& status = emulator.status_;
+
+    runWorkload(emulator, workloads[0]);
+    EXPECT_EQ(status.d << 8 | status.e, 0x2400);
+    EXPECT_EQ(status.h << 8 | status.l, 0x3400);
+
+    runWorkload(emulator, workloads[1]);
+    EXPECT_EQ(status.h << 8 | status.l, 0x5b);
+
+    runWorkload(emulator, workloads[2]);
+    EXPECT_EQ(status.memory[0x2000], 0x00);
+    EXPECT_EQ(status.memory[0x2001], 0x40);
+
+    runWorkload(emulator, workloads[3]);
+    EXPECT_EQ(status.memory[0x2000], 0x00);
+    EXPECT_EQ(status.memory[0x2001], 0x80);
+    EXPECT_EQ(status.memory[0x2002], 0x94);
+    EXPECT_EQ(status.memory[0x2003], 0x04);
+}
+
+TEST(WorkloadsTest, ResetsAndStops) {
+    Emulator emulator;
+    Status& status = emulator.status_;
+    runWorkload(emulator, standardWorkloads()[1]);
+    uint64_t const cycles = status.cycles;
+    status.sp = 0x1234;
+    status.controls.c = true;
+    runWorkload(emulator, standardWorkloads()[1]);
+    EXPECT_EQ(status.cycles, cycles);
+    EXPECT_EQ(status.h << 8 | status.l, 0x5b);
+
+    // A workload that halts before its exit stops there instead of running on.
+    Workload const halts {"halts", {0x00, 0x76}, 0x0010};
+    EXPECT_EQ(runWorkload(emulator, halts), 2u);
+    EXPECT_EQ(status.pc, 0x0002);
+    EXPECT_EQ(status.sp, 0x0000);
+    EXPECT_FALSE(status.controls.c);
+}